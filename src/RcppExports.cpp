@@ -10,6 +10,77 @@ Rcpp::Rostream<true>&  Rcpp::Rcout = Rcpp::Rcpp_cout_get();
 Rcpp::Rostream<false>& Rcpp::Rcerr = Rcpp::Rcpp_cerr_get();
 #endif
 
+// batch_distance
+Rcpp::NumericVector batch_distance(const std::string& query, SEXP choices, std::string metric, Rcpp::Nullable<double> score_cutoff);
+RcppExport SEXP _RapidFuzz_batch_distance(SEXP querySEXP, SEXP choicesSEXP, SEXP metricSEXP, SEXP score_cutoffSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const std::string& >::type query(querySEXP);
+    Rcpp::traits::input_parameter< SEXP >::type choices(choicesSEXP);
+    Rcpp::traits::input_parameter< std::string >::type metric(metricSEXP);
+    Rcpp::traits::input_parameter< Rcpp::Nullable<double> >::type score_cutoff(score_cutoffSEXP);
+    rcpp_result_gen = Rcpp::wrap(batch_distance(query, choices, metric, score_cutoff));
+    return rcpp_result_gen;
+END_RCPP
+}
+// batch_normalized_similarity
+Rcpp::NumericVector batch_normalized_similarity(const std::string& query, SEXP choices, std::string metric, double score_cutoff);
+RcppExport SEXP _RapidFuzz_batch_normalized_similarity(SEXP querySEXP, SEXP choicesSEXP, SEXP metricSEXP, SEXP score_cutoffSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const std::string& >::type query(querySEXP);
+    Rcpp::traits::input_parameter< SEXP >::type choices(choicesSEXP);
+    Rcpp::traits::input_parameter< std::string >::type metric(metricSEXP);
+    Rcpp::traits::input_parameter< double >::type score_cutoff(score_cutoffSEXP);
+    rcpp_result_gen = Rcpp::wrap(batch_normalized_similarity(query, choices, metric, score_cutoff));
+    return rcpp_result_gen;
+END_RCPP
+}
+// batch_token_ratio
+Rcpp::NumericMatrix batch_token_ratio(SEXP queries, SEXP choices, std::string scorer, double score_cutoff);
+RcppExport SEXP _RapidFuzz_batch_token_ratio(SEXP queriesSEXP, SEXP choicesSEXP, SEXP scorerSEXP, SEXP score_cutoffSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type queries(queriesSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type choices(choicesSEXP);
+    Rcpp::traits::input_parameter< std::string >::type scorer(scorerSEXP);
+    Rcpp::traits::input_parameter< double >::type score_cutoff(score_cutoffSEXP);
+    rcpp_result_gen = Rcpp::wrap(batch_token_ratio(queries, choices, scorer, score_cutoff));
+    return rcpp_result_gen;
+END_RCPP
+}
+// batch_fixed_point_similarity
+Rcpp::IntegerMatrix batch_fixed_point_similarity(SEXP queries, SEXP choices, std::string metric, int score_cutoff);
+RcppExport SEXP _RapidFuzz_batch_fixed_point_similarity(SEXP queriesSEXP, SEXP choicesSEXP, SEXP metricSEXP, SEXP score_cutoffSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type queries(queriesSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type choices(choicesSEXP);
+    Rcpp::traits::input_parameter< std::string >::type metric(metricSEXP);
+    Rcpp::traits::input_parameter< int >::type score_cutoff(score_cutoffSEXP);
+    rcpp_result_gen = Rcpp::wrap(batch_fixed_point_similarity(queries, choices, metric, score_cutoff));
+    return rcpp_result_gen;
+END_RCPP
+}
+// batch_dist
+SEXP batch_dist(SEXP strings, std::string metric, bool normalized, std::string format, int num_threads);
+RcppExport SEXP _RapidFuzz_batch_dist(SEXP stringsSEXP, SEXP metricSEXP, SEXP normalizedSEXP, SEXP formatSEXP, SEXP num_threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type strings(stringsSEXP);
+    Rcpp::traits::input_parameter< std::string >::type metric(metricSEXP);
+    Rcpp::traits::input_parameter< bool >::type normalized(normalizedSEXP);
+    Rcpp::traits::input_parameter< std::string >::type format(formatSEXP);
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(batch_dist(strings, metric, normalized, format, num_threads));
+    return rcpp_result_gen;
+END_RCPP
+}
 // damerau_levenshtein_distance
 size_t damerau_levenshtein_distance(std::string s1, std::string s2, Rcpp::Nullable<double> score_cutoff);
 RcppExport SEXP _RapidFuzz_damerau_levenshtein_distance(SEXP s1SEXP, SEXP s2SEXP, SEXP score_cutoffSEXP) {
@@ -63,14 +134,15 @@ BEGIN_RCPP
 END_RCPP
 }
 // get_editops
-DataFrame get_editops(std::string s1, std::string s2);
-RcppExport SEXP _RapidFuzz_get_editops(SEXP s1SEXP, SEXP s2SEXP) {
+DataFrame get_editops(std::string s1, std::string s2, bool types_as_factor);
+RcppExport SEXP _RapidFuzz_get_editops(SEXP s1SEXP, SEXP s2SEXP, SEXP types_as_factorSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< std::string >::type s1(s1SEXP);
     Rcpp::traits::input_parameter< std::string >::type s2(s2SEXP);
-    rcpp_result_gen = Rcpp::wrap(get_editops(s1, s2));
+    Rcpp::traits::input_parameter< bool >::type types_as_factor(types_as_factorSEXP);
+    rcpp_result_gen = Rcpp::wrap(get_editops(s1, s2, types_as_factor));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -126,6 +198,62 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// batch_editops
+Rcpp::DataFrame batch_editops(Rcpp::CharacterVector s1, Rcpp::CharacterVector s2, std::string metric, bool types_as_factor, int num_threads);
+RcppExport SEXP _RapidFuzz_batch_editops(SEXP s1SEXP, SEXP s2SEXP, SEXP metricSEXP, SEXP types_as_factorSEXP, SEXP num_threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type s1(s1SEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type s2(s2SEXP);
+    Rcpp::traits::input_parameter< std::string >::type metric(metricSEXP);
+    Rcpp::traits::input_parameter< bool >::type types_as_factor(types_as_factorSEXP);
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(batch_editops(s1, s2, metric, types_as_factor, num_threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// batch_opcodes
+Rcpp::DataFrame batch_opcodes(Rcpp::CharacterVector s1, Rcpp::CharacterVector s2, std::string metric, bool types_as_factor, int num_threads);
+RcppExport SEXP _RapidFuzz_batch_opcodes(SEXP s1SEXP, SEXP s2SEXP, SEXP metricSEXP, SEXP types_as_factorSEXP, SEXP num_threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type s1(s1SEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type s2(s2SEXP);
+    Rcpp::traits::input_parameter< std::string >::type metric(metricSEXP);
+    Rcpp::traits::input_parameter< bool >::type types_as_factor(types_as_factorSEXP);
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(batch_opcodes(s1, s2, metric, types_as_factor, num_threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// editops_apply_batch
+Rcpp::CharacterVector editops_apply_batch(Rcpp::DataFrame editops, Rcpp::CharacterVector s1, Rcpp::CharacterVector s2);
+RcppExport SEXP _RapidFuzz_editops_apply_batch(SEXP editopsSEXP, SEXP s1SEXP, SEXP s2SEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::DataFrame >::type editops(editopsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type s1(s1SEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type s2(s2SEXP);
+    rcpp_result_gen = Rcpp::wrap(editops_apply_batch(editops, s1, s2));
+    return rcpp_result_gen;
+END_RCPP
+}
+// opcodes_apply_batch
+Rcpp::CharacterVector opcodes_apply_batch(Rcpp::DataFrame opcodes, Rcpp::CharacterVector s1, Rcpp::CharacterVector s2);
+RcppExport SEXP _RapidFuzz_opcodes_apply_batch(SEXP opcodesSEXP, SEXP s1SEXP, SEXP s2SEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::DataFrame >::type opcodes(opcodesSEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type s1(s1SEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type s2(s2SEXP);
+    rcpp_result_gen = Rcpp::wrap(opcodes_apply_batch(opcodes, s1, s2));
+    return rcpp_result_gen;
+END_RCPP
+}
 // processString
 std::string processString(const std::string& input, bool processor, bool asciify);
 RcppExport SEXP _RapidFuzz_processString(SEXP inputSEXP, SEXP processorSEXP, SEXP asciifySEXP) {
@@ -140,27 +268,41 @@ BEGIN_RCPP
 END_RCPP
 }
 // extract_similar_strings
-Rcpp::DataFrame extract_similar_strings(const std::string& query, const std::vector<std::string>& choices, double score_cutoff, bool processor);
+Rcpp::DataFrame extract_similar_strings(const std::string& query, SEXP choices, double score_cutoff, bool processor);
 RcppExport SEXP _RapidFuzz_extract_similar_strings(SEXP querySEXP, SEXP choicesSEXP, SEXP score_cutoffSEXP, SEXP processorSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< const std::string& >::type query(querySEXP);
-    Rcpp::traits::input_parameter< const std::vector<std::string>& >::type choices(choicesSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type choices(choicesSEXP);
     Rcpp::traits::input_parameter< double >::type score_cutoff(score_cutoffSEXP);
     Rcpp::traits::input_parameter< bool >::type processor(processorSEXP);
     rcpp_result_gen = Rcpp::wrap(extract_similar_strings(query, choices, score_cutoff, processor));
     return rcpp_result_gen;
 END_RCPP
 }
+// extract_similar_indices
+Rcpp::DataFrame extract_similar_indices(const std::string& query, SEXP choices, double score_cutoff, bool processor);
+RcppExport SEXP _RapidFuzz_extract_similar_indices(SEXP querySEXP, SEXP choicesSEXP, SEXP score_cutoffSEXP, SEXP processorSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const std::string& >::type query(querySEXP);
+    Rcpp::traits::input_parameter< SEXP >::type choices(choicesSEXP);
+    Rcpp::traits::input_parameter< double >::type score_cutoff(score_cutoffSEXP);
+    Rcpp::traits::input_parameter< bool >::type processor(processorSEXP);
+    rcpp_result_gen = Rcpp::wrap(extract_similar_indices(query, choices, score_cutoff, processor));
+    return rcpp_result_gen;
+END_RCPP
+}
 // extract_best_match
-Rcpp::List extract_best_match(const std::string& query, const std::vector<std::string>& choices, double score_cutoff, bool processor);
+Rcpp::List extract_best_match(const std::string& query, SEXP choices, double score_cutoff, bool processor);
 RcppExport SEXP _RapidFuzz_extract_best_match(SEXP querySEXP, SEXP choicesSEXP, SEXP score_cutoffSEXP, SEXP processorSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< const std::string& >::type query(querySEXP);
-    Rcpp::traits::input_parameter< const std::vector<std::string>& >::type choices(choicesSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type choices(choicesSEXP);
     Rcpp::traits::input_parameter< double >::type score_cutoff(score_cutoffSEXP);
     Rcpp::traits::input_parameter< bool >::type processor(processorSEXP);
     rcpp_result_gen = Rcpp::wrap(extract_best_match(query, choices, score_cutoff, processor));
@@ -168,13 +310,13 @@ BEGIN_RCPP
 END_RCPP
 }
 // extract_matches
-Rcpp::DataFrame extract_matches(const std::string& query, const std::vector<std::string>& choices, double score_cutoff, int limit, bool processor, std::string scorer);
+Rcpp::DataFrame extract_matches(const std::string& query, SEXP choices, double score_cutoff, int limit, bool processor, std::string scorer);
 RcppExport SEXP _RapidFuzz_extract_matches(SEXP querySEXP, SEXP choicesSEXP, SEXP score_cutoffSEXP, SEXP limitSEXP, SEXP processorSEXP, SEXP scorerSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< const std::string& >::type query(querySEXP);
-    Rcpp::traits::input_parameter< const std::vector<std::string>& >::type choices(choicesSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type choices(choicesSEXP);
     Rcpp::traits::input_parameter< double >::type score_cutoff(score_cutoffSEXP);
     Rcpp::traits::input_parameter< int >::type limit(limitSEXP);
     Rcpp::traits::input_parameter< bool >::type processor(processorSEXP);
@@ -183,6 +325,86 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// extract_matches_indices
+Rcpp::DataFrame extract_matches_indices(const std::string& query, SEXP choices, double score_cutoff, int limit, bool processor, std::string scorer);
+RcppExport SEXP _RapidFuzz_extract_matches_indices(SEXP querySEXP, SEXP choicesSEXP, SEXP score_cutoffSEXP, SEXP limitSEXP, SEXP processorSEXP, SEXP scorerSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const std::string& >::type query(querySEXP);
+    Rcpp::traits::input_parameter< SEXP >::type choices(choicesSEXP);
+    Rcpp::traits::input_parameter< double >::type score_cutoff(score_cutoffSEXP);
+    Rcpp::traits::input_parameter< int >::type limit(limitSEXP);
+    Rcpp::traits::input_parameter< bool >::type processor(processorSEXP);
+    Rcpp::traits::input_parameter< std::string >::type scorer(scorerSEXP);
+    rcpp_result_gen = Rcpp::wrap(extract_matches_indices(query, choices, score_cutoff, limit, processor, scorer));
+    return rcpp_result_gen;
+END_RCPP
+}
+// extract_matches_shard
+Rcpp::DataFrame extract_matches_shard(const std::string& query, SEXP choices, int shard, int n_shards, double score_cutoff, int limit, bool processor, std::string scorer);
+RcppExport SEXP _RapidFuzz_extract_matches_shard(SEXP querySEXP, SEXP choicesSEXP, SEXP shardSEXP, SEXP n_shardsSEXP, SEXP score_cutoffSEXP, SEXP limitSEXP, SEXP processorSEXP, SEXP scorerSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const std::string& >::type query(querySEXP);
+    Rcpp::traits::input_parameter< SEXP >::type choices(choicesSEXP);
+    Rcpp::traits::input_parameter< int >::type shard(shardSEXP);
+    Rcpp::traits::input_parameter< int >::type n_shards(n_shardsSEXP);
+    Rcpp::traits::input_parameter< double >::type score_cutoff(score_cutoffSEXP);
+    Rcpp::traits::input_parameter< int >::type limit(limitSEXP);
+    Rcpp::traits::input_parameter< bool >::type processor(processorSEXP);
+    Rcpp::traits::input_parameter< std::string >::type scorer(scorerSEXP);
+    rcpp_result_gen = Rcpp::wrap(extract_matches_shard(query, choices, shard, n_shards, score_cutoff, limit, processor, scorer));
+    return rcpp_result_gen;
+END_RCPP
+}
+// merge_matches
+Rcpp::DataFrame merge_matches(Rcpp::List results, int limit);
+RcppExport SEXP _RapidFuzz_merge_matches(SEXP resultsSEXP, SEXP limitSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List >::type results(resultsSEXP);
+    Rcpp::traits::input_parameter< int >::type limit(limitSEXP);
+    rcpp_result_gen = Rcpp::wrap(merge_matches(results, limit));
+    return rcpp_result_gen;
+END_RCPP
+}
+// extract_matches_batch
+Rcpp::DataFrame extract_matches_batch(SEXP queries, SEXP choices, double score_cutoff, int limit, bool processor, std::string scorer, int num_threads);
+RcppExport SEXP _RapidFuzz_extract_matches_batch(SEXP queriesSEXP, SEXP choicesSEXP, SEXP score_cutoffSEXP, SEXP limitSEXP, SEXP processorSEXP, SEXP scorerSEXP, SEXP num_threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type queries(queriesSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type choices(choicesSEXP);
+    Rcpp::traits::input_parameter< double >::type score_cutoff(score_cutoffSEXP);
+    Rcpp::traits::input_parameter< int >::type limit(limitSEXP);
+    Rcpp::traits::input_parameter< bool >::type processor(processorSEXP);
+    Rcpp::traits::input_parameter< std::string >::type scorer(scorerSEXP);
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(extract_matches_batch(queries, choices, score_cutoff, limit, processor, scorer, num_threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// extract_similar_pairs
+SEXP extract_similar_pairs(SEXP queries, SEXP choices, double score_cutoff, bool processor, std::string scorer, int num_threads, std::string format);
+RcppExport SEXP _RapidFuzz_extract_similar_pairs(SEXP queriesSEXP, SEXP choicesSEXP, SEXP score_cutoffSEXP, SEXP processorSEXP, SEXP scorerSEXP, SEXP num_threadsSEXP, SEXP formatSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type queries(queriesSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type choices(choicesSEXP);
+    Rcpp::traits::input_parameter< double >::type score_cutoff(score_cutoffSEXP);
+    Rcpp::traits::input_parameter< bool >::type processor(processorSEXP);
+    Rcpp::traits::input_parameter< std::string >::type scorer(scorerSEXP);
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
+    Rcpp::traits::input_parameter< std::string >::type format(formatSEXP);
+    rcpp_result_gen = Rcpp::wrap(extract_similar_pairs(queries, choices, score_cutoff, processor, scorer, num_threads, format));
+    return rcpp_result_gen;
+END_RCPP
+}
 // fuzz_ratio
 double fuzz_ratio(std::string s1, std::string s2, double score_cutoff);
 RcppExport SEXP _RapidFuzz_fuzz_ratio(SEXP s1SEXP, SEXP s2SEXP, SEXP score_cutoffSEXP) {
@@ -326,6 +548,53 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// incremental_matcher
+SEXP incremental_matcher(const std::vector<std::string>& choices, int max_distance);
+RcppExport SEXP _RapidFuzz_incremental_matcher(SEXP choicesSEXP, SEXP max_distanceSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const std::vector<std::string>& >::type choices(choicesSEXP);
+    Rcpp::traits::input_parameter< int >::type max_distance(max_distanceSEXP);
+    rcpp_result_gen = Rcpp::wrap(incremental_matcher(choices, max_distance));
+    return rcpp_result_gen;
+END_RCPP
+}
+// incremental_matcher_push
+DataFrame incremental_matcher_push(SEXP matcher, std::string chars);
+RcppExport SEXP _RapidFuzz_incremental_matcher_push(SEXP matcherSEXP, SEXP charsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type matcher(matcherSEXP);
+    Rcpp::traits::input_parameter< std::string >::type chars(charsSEXP);
+    rcpp_result_gen = Rcpp::wrap(incremental_matcher_push(matcher, chars));
+    return rcpp_result_gen;
+END_RCPP
+}
+// incremental_matcher_pop
+DataFrame incremental_matcher_pop(SEXP matcher, int n);
+RcppExport SEXP _RapidFuzz_incremental_matcher_pop(SEXP matcherSEXP, SEXP nSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type matcher(matcherSEXP);
+    Rcpp::traits::input_parameter< int >::type n(nSEXP);
+    rcpp_result_gen = Rcpp::wrap(incremental_matcher_pop(matcher, n));
+    return rcpp_result_gen;
+END_RCPP
+}
+// incremental_matcher_matches
+DataFrame incremental_matcher_matches(SEXP matcher);
+RcppExport SEXP _RapidFuzz_incremental_matcher_matches(SEXP matcherSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type matcher(matcherSEXP);
+    rcpp_result_gen = Rcpp::wrap(incremental_matcher_matches(matcher));
+    return rcpp_result_gen;
+END_RCPP
+}
 // indel_distance
 size_t indel_distance(std::string s1, std::string s2);
 RcppExport SEXP _RapidFuzz_indel_distance(SEXP s1SEXP, SEXP s2SEXP) {
@@ -474,6 +743,32 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// lazy_similarity_matrix
+SEXP lazy_similarity_matrix(SEXP queries, SEXP choices, std::string metric, int block_rows, bool cache);
+RcppExport SEXP _RapidFuzz_lazy_similarity_matrix(SEXP queriesSEXP, SEXP choicesSEXP, SEXP metricSEXP, SEXP block_rowsSEXP, SEXP cacheSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type queries(queriesSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type choices(choicesSEXP);
+    Rcpp::traits::input_parameter< std::string >::type metric(metricSEXP);
+    Rcpp::traits::input_parameter< int >::type block_rows(block_rowsSEXP);
+    Rcpp::traits::input_parameter< bool >::type cache(cacheSEXP);
+    rcpp_result_gen = Rcpp::wrap(lazy_similarity_matrix(queries, choices, metric, block_rows, cache));
+    return rcpp_result_gen;
+END_RCPP
+}
+// lazy_matrix_info
+Rcpp::List lazy_matrix_info(SEXP x);
+RcppExport SEXP _RapidFuzz_lazy_matrix_info(SEXP xSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type x(xSEXP);
+    rcpp_result_gen = Rcpp::wrap(lazy_matrix_info(x));
+    return rcpp_result_gen;
+END_RCPP
+}
 // lcs_seq_distance
 size_t lcs_seq_distance(std::string s1, std::string s2, Rcpp::Nullable<double> score_cutoff);
 RcppExport SEXP _RapidFuzz_lcs_seq_distance(SEXP s1SEXP, SEXP s2SEXP, SEXP score_cutoffSEXP) {
@@ -527,14 +822,15 @@ BEGIN_RCPP
 END_RCPP
 }
 // lcs_seq_editops
-DataFrame lcs_seq_editops(std::string s1, std::string s2);
-RcppExport SEXP _RapidFuzz_lcs_seq_editops(SEXP s1SEXP, SEXP s2SEXP) {
+DataFrame lcs_seq_editops(std::string s1, std::string s2, bool types_as_factor);
+RcppExport SEXP _RapidFuzz_lcs_seq_editops(SEXP s1SEXP, SEXP s2SEXP, SEXP types_as_factorSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< std::string >::type s1(s1SEXP);
     Rcpp::traits::input_parameter< std::string >::type s2(s2SEXP);
-    rcpp_result_gen = Rcpp::wrap(lcs_seq_editops(s1, s2));
+    Rcpp::traits::input_parameter< bool >::type types_as_factor(types_as_factorSEXP);
+    rcpp_result_gen = Rcpp::wrap(lcs_seq_editops(s1, s2, types_as_factor));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -586,6 +882,51 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// levenshtein_search
+DataFrame levenshtein_search(std::string pattern, const std::vector<std::string>& text, int max_distance, bool return_start);
+RcppExport SEXP _RapidFuzz_levenshtein_search(SEXP patternSEXP, SEXP textSEXP, SEXP max_distanceSEXP, SEXP return_startSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type pattern(patternSEXP);
+    Rcpp::traits::input_parameter< const std::vector<std::string>& >::type text(textSEXP);
+    Rcpp::traits::input_parameter< int >::type max_distance(max_distanceSEXP);
+    Rcpp::traits::input_parameter< bool >::type return_start(return_startSEXP);
+    rcpp_result_gen = Rcpp::wrap(levenshtein_search(pattern, text, max_distance, return_start));
+    return rcpp_result_gen;
+END_RCPP
+}
+// levenshtein_search_file
+DataFrame levenshtein_search_file(std::string pattern, std::string path, int max_distance, bool return_start, int chunk_size);
+RcppExport SEXP _RapidFuzz_levenshtein_search_file(SEXP patternSEXP, SEXP pathSEXP, SEXP max_distanceSEXP, SEXP return_startSEXP, SEXP chunk_sizeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type pattern(patternSEXP);
+    Rcpp::traits::input_parameter< std::string >::type path(pathSEXP);
+    Rcpp::traits::input_parameter< int >::type max_distance(max_distanceSEXP);
+    Rcpp::traits::input_parameter< bool >::type return_start(return_startSEXP);
+    Rcpp::traits::input_parameter< int >::type chunk_size(chunk_sizeSEXP);
+    rcpp_result_gen = Rcpp::wrap(levenshtein_search_file(pattern, path, max_distance, return_start, chunk_size));
+    return rcpp_result_gen;
+END_RCPP
+}
+// pair_metrics
+Rcpp::NumericMatrix pair_metrics(SEXP s1, SEXP s2, Rcpp::CharacterVector metrics, bool normalized, double prefix_weight, int num_threads);
+RcppExport SEXP _RapidFuzz_pair_metrics(SEXP s1SEXP, SEXP s2SEXP, SEXP metricsSEXP, SEXP normalizedSEXP, SEXP prefix_weightSEXP, SEXP num_threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type s1(s1SEXP);
+    Rcpp::traits::input_parameter< SEXP >::type s2(s2SEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type metrics(metricsSEXP);
+    Rcpp::traits::input_parameter< bool >::type normalized(normalizedSEXP);
+    Rcpp::traits::input_parameter< double >::type prefix_weight(prefix_weightSEXP);
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(pair_metrics(s1, s2, metrics, normalized, prefix_weight, num_threads));
+    return rcpp_result_gen;
+END_RCPP
+}
 // osa_normalized_similarity
 double osa_normalized_similarity(std::string s1, std::string s2, double score_cutoff);
 RcppExport SEXP _RapidFuzz_osa_normalized_similarity(SEXP s1SEXP, SEXP s2SEXP, SEXP score_cutoffSEXP) {
@@ -600,14 +941,15 @@ BEGIN_RCPP
 END_RCPP
 }
 // osa_editops
-DataFrame osa_editops(std::string s1, std::string s2);
-RcppExport SEXP _RapidFuzz_osa_editops(SEXP s1SEXP, SEXP s2SEXP) {
+DataFrame osa_editops(std::string s1, std::string s2, bool types_as_factor);
+RcppExport SEXP _RapidFuzz_osa_editops(SEXP s1SEXP, SEXP s2SEXP, SEXP types_as_factorSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< std::string >::type s1(s1SEXP);
     Rcpp::traits::input_parameter< std::string >::type s2(s2SEXP);
-    rcpp_result_gen = Rcpp::wrap(osa_editops(s1, s2));
+    Rcpp::traits::input_parameter< bool >::type types_as_factor(types_as_factorSEXP);
+    rcpp_result_gen = Rcpp::wrap(osa_editops(s1, s2, types_as_factor));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -650,6 +992,29 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// string_pool
+SEXP string_pool(Rcpp::CharacterVector strings, bool decode);
+RcppExport SEXP _RapidFuzz_string_pool(SEXP stringsSEXP, SEXP decodeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type strings(stringsSEXP);
+    Rcpp::traits::input_parameter< bool >::type decode(decodeSEXP);
+    rcpp_result_gen = Rcpp::wrap(string_pool(strings, decode));
+    return rcpp_result_gen;
+END_RCPP
+}
+// string_pool_info
+Rcpp::List string_pool_info(SEXP pool);
+RcppExport SEXP _RapidFuzz_string_pool_info(SEXP poolSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type pool(poolSEXP);
+    rcpp_result_gen = Rcpp::wrap(string_pool_info(pool));
+    return rcpp_result_gen;
+END_RCPP
+}
 // postfix_distance
 size_t postfix_distance(std::string s1, std::string s2, Rcpp::Nullable<double> score_cutoff);
 RcppExport SEXP _RapidFuzz_postfix_distance(SEXP s1SEXP, SEXP s2SEXP, SEXP score_cutoffSEXP) {
@@ -754,21 +1119,84 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// scratch_stats
+Rcpp::List scratch_stats(bool reset);
+RcppExport SEXP _RapidFuzz_scratch_stats(SEXP resetSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< bool >::type reset(resetSEXP);
+    rcpp_result_gen = Rcpp::wrap(scratch_stats(reset));
+    return rcpp_result_gen;
+END_RCPP
+}
+// word_levenshtein_distance
+Rcpp::NumericVector word_levenshtein_distance(const std::vector<std::string>& s1, const std::vector<std::string>& s2);
+RcppExport SEXP _RapidFuzz_word_levenshtein_distance(SEXP s1SEXP, SEXP s2SEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const std::vector<std::string>& >::type s1(s1SEXP);
+    Rcpp::traits::input_parameter< const std::vector<std::string>& >::type s2(s2SEXP);
+    rcpp_result_gen = Rcpp::wrap(word_levenshtein_distance(s1, s2));
+    return rcpp_result_gen;
+END_RCPP
+}
+// word_lcs_seq_distance
+Rcpp::NumericVector word_lcs_seq_distance(const std::vector<std::string>& s1, const std::vector<std::string>& s2);
+RcppExport SEXP _RapidFuzz_word_lcs_seq_distance(SEXP s1SEXP, SEXP s2SEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const std::vector<std::string>& >::type s1(s1SEXP);
+    Rcpp::traits::input_parameter< const std::vector<std::string>& >::type s2(s2SEXP);
+    rcpp_result_gen = Rcpp::wrap(word_lcs_seq_distance(s1, s2));
+    return rcpp_result_gen;
+END_RCPP
+}
+// word_editops
+DataFrame word_editops(const std::vector<std::string>& s1, const std::vector<std::string>& s2, bool types_as_factor);
+RcppExport SEXP _RapidFuzz_word_editops(SEXP s1SEXP, SEXP s2SEXP, SEXP types_as_factorSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const std::vector<std::string>& >::type s1(s1SEXP);
+    Rcpp::traits::input_parameter< const std::vector<std::string>& >::type s2(s2SEXP);
+    Rcpp::traits::input_parameter< bool >::type types_as_factor(types_as_factorSEXP);
+    rcpp_result_gen = Rcpp::wrap(word_editops(s1, s2, types_as_factor));
+    return rcpp_result_gen;
+END_RCPP
+}
 
 static const R_CallMethodDef CallEntries[] = {
+    {"_RapidFuzz_batch_distance", (DL_FUNC) &_RapidFuzz_batch_distance, 4},
+    {"_RapidFuzz_batch_normalized_similarity", (DL_FUNC) &_RapidFuzz_batch_normalized_similarity, 4},
+    {"_RapidFuzz_batch_token_ratio", (DL_FUNC) &_RapidFuzz_batch_token_ratio, 4},
+    {"_RapidFuzz_batch_fixed_point_similarity", (DL_FUNC) &_RapidFuzz_batch_fixed_point_similarity, 4},
+    {"_RapidFuzz_batch_dist", (DL_FUNC) &_RapidFuzz_batch_dist, 5},
     {"_RapidFuzz_damerau_levenshtein_distance", (DL_FUNC) &_RapidFuzz_damerau_levenshtein_distance, 3},
     {"_RapidFuzz_damerau_levenshtein_similarity", (DL_FUNC) &_RapidFuzz_damerau_levenshtein_similarity, 3},
     {"_RapidFuzz_damerau_levenshtein_normalized_distance", (DL_FUNC) &_RapidFuzz_damerau_levenshtein_normalized_distance, 3},
     {"_RapidFuzz_damerau_levenshtein_normalized_similarity", (DL_FUNC) &_RapidFuzz_damerau_levenshtein_normalized_similarity, 3},
-    {"_RapidFuzz_get_editops", (DL_FUNC) &_RapidFuzz_get_editops, 2},
+    {"_RapidFuzz_get_editops", (DL_FUNC) &_RapidFuzz_get_editops, 3},
     {"_RapidFuzz_editops_apply_str", (DL_FUNC) &_RapidFuzz_editops_apply_str, 3},
     {"_RapidFuzz_opcodes_apply_str", (DL_FUNC) &_RapidFuzz_opcodes_apply_str, 3},
     {"_RapidFuzz_opcodes_apply_vec", (DL_FUNC) &_RapidFuzz_opcodes_apply_vec, 3},
     {"_RapidFuzz_editops_apply_vec", (DL_FUNC) &_RapidFuzz_editops_apply_vec, 3},
+    {"_RapidFuzz_batch_editops", (DL_FUNC) &_RapidFuzz_batch_editops, 5},
+    {"_RapidFuzz_batch_opcodes", (DL_FUNC) &_RapidFuzz_batch_opcodes, 5},
+    {"_RapidFuzz_editops_apply_batch", (DL_FUNC) &_RapidFuzz_editops_apply_batch, 3},
+    {"_RapidFuzz_opcodes_apply_batch", (DL_FUNC) &_RapidFuzz_opcodes_apply_batch, 3},
     {"_RapidFuzz_processString", (DL_FUNC) &_RapidFuzz_processString, 3},
     {"_RapidFuzz_extract_similar_strings", (DL_FUNC) &_RapidFuzz_extract_similar_strings, 4},
+    {"_RapidFuzz_extract_similar_indices", (DL_FUNC) &_RapidFuzz_extract_similar_indices, 4},
     {"_RapidFuzz_extract_best_match", (DL_FUNC) &_RapidFuzz_extract_best_match, 4},
     {"_RapidFuzz_extract_matches", (DL_FUNC) &_RapidFuzz_extract_matches, 6},
+    {"_RapidFuzz_extract_matches_indices", (DL_FUNC) &_RapidFuzz_extract_matches_indices, 6},
+    {"_RapidFuzz_extract_matches_shard", (DL_FUNC) &_RapidFuzz_extract_matches_shard, 8},
+    {"_RapidFuzz_merge_matches", (DL_FUNC) &_RapidFuzz_merge_matches, 2},
+    {"_RapidFuzz_extract_matches_batch", (DL_FUNC) &_RapidFuzz_extract_matches_batch, 7},
+    {"_RapidFuzz_extract_similar_pairs", (DL_FUNC) &_RapidFuzz_extract_similar_pairs, 7},
     {"_RapidFuzz_fuzz_ratio", (DL_FUNC) &_RapidFuzz_fuzz_ratio, 3},
     {"_RapidFuzz_fuzz_partial_ratio", (DL_FUNC) &_RapidFuzz_fuzz_partial_ratio, 3},
     {"_RapidFuzz_fuzz_token_sort_ratio", (DL_FUNC) &_RapidFuzz_fuzz_token_sort_ratio, 3},
@@ -780,6 +1208,10 @@ static const R_CallMethodDef CallEntries[] = {
     {"_RapidFuzz_hamming_similarity", (DL_FUNC) &_RapidFuzz_hamming_similarity, 3},
     {"_RapidFuzz_hamming_normalized_distance", (DL_FUNC) &_RapidFuzz_hamming_normalized_distance, 3},
     {"_RapidFuzz_hamming_normalized_similarity", (DL_FUNC) &_RapidFuzz_hamming_normalized_similarity, 3},
+    {"_RapidFuzz_incremental_matcher", (DL_FUNC) &_RapidFuzz_incremental_matcher, 2},
+    {"_RapidFuzz_incremental_matcher_push", (DL_FUNC) &_RapidFuzz_incremental_matcher_push, 2},
+    {"_RapidFuzz_incremental_matcher_pop", (DL_FUNC) &_RapidFuzz_incremental_matcher_pop, 2},
+    {"_RapidFuzz_incremental_matcher_matches", (DL_FUNC) &_RapidFuzz_incremental_matcher_matches, 1},
     {"_RapidFuzz_indel_distance", (DL_FUNC) &_RapidFuzz_indel_distance, 2},
     {"_RapidFuzz_indel_normalized_distance", (DL_FUNC) &_RapidFuzz_indel_normalized_distance, 2},
     {"_RapidFuzz_indel_similarity", (DL_FUNC) &_RapidFuzz_indel_similarity, 2},
@@ -792,20 +1224,27 @@ static const R_CallMethodDef CallEntries[] = {
     {"_RapidFuzz_jaro_winkler_similarity", (DL_FUNC) &_RapidFuzz_jaro_winkler_similarity, 3},
     {"_RapidFuzz_jaro_winkler_normalized_distance", (DL_FUNC) &_RapidFuzz_jaro_winkler_normalized_distance, 3},
     {"_RapidFuzz_jaro_winkler_normalized_similarity", (DL_FUNC) &_RapidFuzz_jaro_winkler_normalized_similarity, 3},
+    {"_RapidFuzz_lazy_similarity_matrix", (DL_FUNC) &_RapidFuzz_lazy_similarity_matrix, 5},
+    {"_RapidFuzz_lazy_matrix_info", (DL_FUNC) &_RapidFuzz_lazy_matrix_info, 1},
     {"_RapidFuzz_lcs_seq_distance", (DL_FUNC) &_RapidFuzz_lcs_seq_distance, 3},
     {"_RapidFuzz_lcs_seq_similarity", (DL_FUNC) &_RapidFuzz_lcs_seq_similarity, 3},
     {"_RapidFuzz_lcs_seq_normalized_distance", (DL_FUNC) &_RapidFuzz_lcs_seq_normalized_distance, 3},
     {"_RapidFuzz_lcs_seq_normalized_similarity", (DL_FUNC) &_RapidFuzz_lcs_seq_normalized_similarity, 3},
-    {"_RapidFuzz_lcs_seq_editops", (DL_FUNC) &_RapidFuzz_lcs_seq_editops, 2},
+    {"_RapidFuzz_lcs_seq_editops", (DL_FUNC) &_RapidFuzz_lcs_seq_editops, 3},
     {"_RapidFuzz_levenshtein_distance", (DL_FUNC) &_RapidFuzz_levenshtein_distance, 2},
     {"_RapidFuzz_levenshtein_normalized_distance", (DL_FUNC) &_RapidFuzz_levenshtein_normalized_distance, 2},
     {"_RapidFuzz_levenshtein_similarity", (DL_FUNC) &_RapidFuzz_levenshtein_similarity, 2},
     {"_RapidFuzz_levenshtein_normalized_similarity", (DL_FUNC) &_RapidFuzz_levenshtein_normalized_similarity, 2},
+    {"_RapidFuzz_levenshtein_search", (DL_FUNC) &_RapidFuzz_levenshtein_search, 4},
+    {"_RapidFuzz_levenshtein_search_file", (DL_FUNC) &_RapidFuzz_levenshtein_search_file, 5},
+    {"_RapidFuzz_pair_metrics", (DL_FUNC) &_RapidFuzz_pair_metrics, 6},
     {"_RapidFuzz_osa_normalized_similarity", (DL_FUNC) &_RapidFuzz_osa_normalized_similarity, 3},
-    {"_RapidFuzz_osa_editops", (DL_FUNC) &_RapidFuzz_osa_editops, 2},
+    {"_RapidFuzz_osa_editops", (DL_FUNC) &_RapidFuzz_osa_editops, 3},
     {"_RapidFuzz_osa_distance", (DL_FUNC) &_RapidFuzz_osa_distance, 3},
     {"_RapidFuzz_osa_similarity", (DL_FUNC) &_RapidFuzz_osa_similarity, 3},
     {"_RapidFuzz_osa_normalized_distance", (DL_FUNC) &_RapidFuzz_osa_normalized_distance, 3},
+    {"_RapidFuzz_string_pool", (DL_FUNC) &_RapidFuzz_string_pool, 2},
+    {"_RapidFuzz_string_pool_info", (DL_FUNC) &_RapidFuzz_string_pool_info, 1},
     {"_RapidFuzz_postfix_distance", (DL_FUNC) &_RapidFuzz_postfix_distance, 3},
     {"_RapidFuzz_postfix_similarity", (DL_FUNC) &_RapidFuzz_postfix_similarity, 3},
     {"_RapidFuzz_postfix_normalized_distance", (DL_FUNC) &_RapidFuzz_postfix_normalized_distance, 3},
@@ -814,10 +1253,16 @@ static const R_CallMethodDef CallEntries[] = {
     {"_RapidFuzz_prefix_similarity", (DL_FUNC) &_RapidFuzz_prefix_similarity, 3},
     {"_RapidFuzz_prefix_normalized_distance", (DL_FUNC) &_RapidFuzz_prefix_normalized_distance, 3},
     {"_RapidFuzz_prefix_normalized_similarity", (DL_FUNC) &_RapidFuzz_prefix_normalized_similarity, 3},
+    {"_RapidFuzz_scratch_stats", (DL_FUNC) &_RapidFuzz_scratch_stats, 1},
+    {"_RapidFuzz_word_levenshtein_distance", (DL_FUNC) &_RapidFuzz_word_levenshtein_distance, 2},
+    {"_RapidFuzz_word_lcs_seq_distance", (DL_FUNC) &_RapidFuzz_word_lcs_seq_distance, 2},
+    {"_RapidFuzz_word_editops", (DL_FUNC) &_RapidFuzz_word_editops, 3},
     {NULL, NULL, 0}
 };
 
+void registerLazyMatrix(DllInfo* dll);
 RcppExport void R_init_RapidFuzz(DllInfo *dll) {
     R_registerRoutines(dll, NULL, CallEntries, NULL, NULL);
     R_useDynamicSymbols(dll, FALSE);
+    registerLazyMatrix(dll);
 }
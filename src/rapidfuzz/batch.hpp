@@ -0,0 +1,811 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright © 2022-present Max Bachmann */
+
+#pragma once
+#include <rapidfuzz/details/CharHistogram.hpp>
+#include <rapidfuzz/distance.hpp>
+#include <rapidfuzz/fuzz.hpp>
+#include <rapidfuzz/tokens.hpp>
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace rapidfuzz {
+
+namespace detail {
+
+/**
+ * @brief width of the smallest Multi* lane the string fits into
+ *
+ * @return 8, 16, 32 or 64 for strings that can be scored in SIMD lanes
+ * and 0 for strings that have to be scored with the Cached* scorers
+ */
+static inline size_t length_bucket_width(size_t len)
+{
+    if (len <= 8) return 8;
+    if (len <= 16) return 16;
+    if (len <= 32) return 32;
+    if (len <= 64) return 64;
+    return 0;
+}
+
+/**
+ * @brief length closest to len2 inside the range [min_len, max_len]
+ *
+ * All bounds below grow monotonically with the distance between the
+ * two lengths, so the bound of a whole bucket is the bound of this length.
+ */
+static inline size_t closest_length(size_t min_len, size_t max_len, size_t len2)
+{
+    return std::min(std::max(len2, min_len), max_len);
+}
+
+/**
+ * @brief scale of the fixed point similarities, which store a normalized similarity
+ * of 1.0 as 10000, so they fit into an uint16_t
+ */
+static constexpr size_t FIXED_POINT_SCALE = 10000;
+
+/**
+ * @brief largest distance with a fixed point similarity >= score_cutoff.
+ * The fixed point similarity is (maximum - dist) * FIXED_POINT_SCALE / maximum rounded down
+ */
+static inline size_t fixed_point_max_distance(size_t maximum, size_t score_cutoff)
+{
+    return maximum - ceil_div(score_cutoff * maximum, FIXED_POINT_SCALE);
+}
+
+static inline uint16_t fixed_point_similarity(size_t maximum, size_t dist)
+{
+    if (!maximum) return static_cast<uint16_t>(FIXED_POINT_SCALE);
+    return static_cast<uint16_t>((maximum - dist) * FIXED_POINT_SCALE / maximum);
+}
+
+/**
+ * @brief bounds shared by the uniform edit distances (Levenshtein, OSA, LCSseq),
+ * where the maximum is max(len1, len2). hist_diff is the L1 difference of the
+ * character histograms or 0 when only the lengths are known
+ */
+struct EditBound {
+    static size_t maximum(size_t len1, size_t len2)
+    {
+        return std::max(len1, len2);
+    }
+
+    static size_t distance(size_t len1, size_t len2, size_t hist_diff = 0)
+    {
+        return levenshtein_lower_bound(len1, len2, hist_diff);
+    }
+
+    static double normalized_distance(size_t len1, size_t len2, size_t hist_diff = 0)
+    {
+        size_t maximum = EditBound::maximum(len1, len2);
+        return maximum ? static_cast<double>(distance(len1, len2, hist_diff)) / static_cast<double>(maximum)
+                       : 0.0;
+    }
+};
+
+/**
+ * @brief bounds of the Indel distance, where the maximum is len1 + len2
+ */
+struct IndelBound {
+    static size_t maximum(size_t len1, size_t len2)
+    {
+        return len1 + len2;
+    }
+
+    static size_t distance(size_t len1, size_t len2, size_t hist_diff = 0)
+    {
+        return indel_lower_bound(len1, len2, hist_diff);
+    }
+
+    static double normalized_distance(size_t len1, size_t len2, size_t hist_diff = 0)
+    {
+        size_t maximum = IndelBound::maximum(len1, len2);
+        return maximum ? static_cast<double>(distance(len1, len2, hist_diff)) / static_cast<double>(maximum)
+                       : 0.0;
+    }
+};
+
+/**
+ * @brief bounds of the Jaro distance. The similarity is at most
+ * (m / len1 + m / len2 + 1) / 3 for m matching characters
+ */
+struct JaroBound {
+    static double distance(size_t len1, size_t len2, size_t hist_diff = 0)
+    {
+        return normalized_distance(len1, len2, hist_diff);
+    }
+
+    static double normalized_distance(size_t len1, size_t len2, size_t hist_diff = 0)
+    {
+        if (!len1 && !len2) return 0.0;
+
+        size_t matches = jaro_match_upper_bound(len1, len2, hist_diff);
+        if (!matches) return 1.0;
+
+        double m = static_cast<double>(matches);
+        double sim = (m / static_cast<double>(len1) + m / static_cast<double>(len2) + 1.0) / 3.0;
+        /* slightly loosened, so rounding never rejects a string reaching the bound exactly */
+        return std::max(0.0, 1.0 - sim - 1e-12);
+    }
+};
+
+/**
+ * @brief bounds for metrics without a useful length or histogram bound
+ */
+struct NoBound {
+    static size_t distance(size_t, size_t, size_t = 0)
+    {
+        return 0;
+    }
+
+    static double normalized_distance(size_t, size_t, size_t = 0)
+    {
+        return 0.0;
+    }
+};
+
+} // namespace detail
+
+namespace experimental {
+
+/*
+ * metric descriptions used by BatchScorer. Each of them knows how to create the
+ * SIMD scorer for a lane width, the cached scorer for long strings and the
+ * length and histogram bounds of the metric
+ */
+
+struct LevenshteinMetric {
+    using ResType = size_t;
+    using Bound = detail::EditBound;
+
+#ifdef RAPIDFUZZ_SIMD
+    template <int MaxLen>
+    using Multi = MultiLevenshtein<MaxLen>;
+
+    template <int MaxLen>
+    std::unique_ptr<Multi<MaxLen>> make_multi(size_t count) const
+    {
+        return std::make_unique<Multi<MaxLen>>(count);
+    }
+#endif
+
+    template <typename Sentence>
+    auto make_cached(const Sentence& s) const
+    {
+        return CachedLevenshtein<char_type<Sentence>>(s);
+    }
+};
+
+struct IndelMetric {
+    using ResType = size_t;
+    using Bound = detail::IndelBound;
+
+#ifdef RAPIDFUZZ_SIMD
+    template <int MaxLen>
+    using Multi = MultiIndel<MaxLen>;
+
+    template <int MaxLen>
+    std::unique_ptr<Multi<MaxLen>> make_multi(size_t count) const
+    {
+        return std::make_unique<Multi<MaxLen>>(count);
+    }
+#endif
+
+    template <typename Sentence>
+    auto make_cached(const Sentence& s) const
+    {
+        return CachedIndel<char_type<Sentence>>(s);
+    }
+};
+
+struct LCSseqMetric {
+    using ResType = size_t;
+    using Bound = detail::EditBound;
+
+#ifdef RAPIDFUZZ_SIMD
+    template <int MaxLen>
+    using Multi = MultiLCSseq<MaxLen>;
+
+    template <int MaxLen>
+    std::unique_ptr<Multi<MaxLen>> make_multi(size_t count) const
+    {
+        return std::make_unique<Multi<MaxLen>>(count);
+    }
+#endif
+
+    template <typename Sentence>
+    auto make_cached(const Sentence& s) const
+    {
+        return CachedLCSseq<char_type<Sentence>>(s);
+    }
+};
+
+struct OSAMetric {
+    using ResType = size_t;
+    using Bound = detail::EditBound;
+
+#ifdef RAPIDFUZZ_SIMD
+    template <int MaxLen>
+    using Multi = MultiOSA<MaxLen>;
+
+    template <int MaxLen>
+    std::unique_ptr<Multi<MaxLen>> make_multi(size_t count) const
+    {
+        return std::make_unique<Multi<MaxLen>>(count);
+    }
+#endif
+
+    template <typename Sentence>
+    auto make_cached(const Sentence& s) const
+    {
+        return CachedOSA<char_type<Sentence>>(s);
+    }
+};
+
+struct JaroMetric {
+    using ResType = double;
+    using Bound = detail::JaroBound;
+
+#ifdef RAPIDFUZZ_SIMD
+    template <int MaxLen>
+    using Multi = MultiJaro<MaxLen>;
+
+    template <int MaxLen>
+    std::unique_ptr<Multi<MaxLen>> make_multi(size_t count) const
+    {
+        return std::make_unique<Multi<MaxLen>>(count);
+    }
+#endif
+
+    template <typename Sentence>
+    auto make_cached(const Sentence& s) const
+    {
+        return CachedJaro<char_type<Sentence>>(s);
+    }
+};
+
+struct JaroWinklerMetric {
+    using ResType = double;
+    using Bound = detail::NoBound;
+
+    double prefix_weight = 0.1;
+
+#ifdef RAPIDFUZZ_SIMD
+    template <int MaxLen>
+    using Multi = MultiJaroWinkler<MaxLen>;
+
+    template <int MaxLen>
+    std::unique_ptr<Multi<MaxLen>> make_multi(size_t count) const
+    {
+        return std::make_unique<Multi<MaxLen>>(count, prefix_weight);
+    }
+#endif
+
+    template <typename Sentence>
+    auto make_cached(const Sentence& s) const
+    {
+        return CachedJaroWinkler<char_type<Sentence>>(s, prefix_weight);
+    }
+};
+
+/**
+ * @brief number of candidates rejected by each prefilter stage of BatchScorer
+ */
+struct PrefilterStats {
+    size_t length = 0;    /* rejected based on the length difference */
+    size_t histogram = 0; /* rejected based on the character histograms */
+    size_t scored = 0;    /* passed both filters */
+};
+
+/**
+ * @brief scores one string against a batch of strings
+ *
+ * The strings are grouped into length buckets, so every bucket is scored by
+ * the narrowest Multi* scorer it fits into (uint8 lanes for strings with up
+ * to 8 characters, uint16 lanes for up to 16 characters ...) instead of padding
+ * the whole batch to the widest string. Strings with more than 64 characters
+ * are scored with the Cached* scorers.
+ *
+ * Before any kernel runs, candidates are rejected using the length difference
+ * and the L1 difference of their character histograms. Buckets that can not
+ * reach the score_cutoff based on their length range, or in which no candidate
+ * survives the prefilters, are skipped completely.
+ *
+ * Scores are always written to the original position of a string.
+ *
+ * @tparam CharT1 character type of the batch
+ * @tparam Metric one of LevenshteinMetric, IndelMetric, LCSseqMetric,
+ * OSAMetric, JaroMetric, JaroWinklerMetric
+ */
+template <typename CharT1, typename Metric>
+class BatchScorer {
+public:
+    using ResType = typename Metric::ResType;
+
+    template <typename Sentence1>
+    explicit BatchScorer(const std::vector<Sentence1>& strings, Metric metric_ = Metric())
+        : BatchScorer(strings.begin(), strings.end(), metric_)
+    {}
+
+    template <typename InputIt>
+    BatchScorer(InputIt first, InputIt last, Metric metric_ = Metric()) : metric(metric_)
+    {
+        input_count = static_cast<size_t>(std::distance(first, last));
+        lens.reserve(input_count);
+        histograms.reserve(input_count);
+
+        size_t idx = 0;
+        for (auto it = first; it != last; ++it, ++idx) {
+            auto s = detail::Range(*it);
+            size_t len = s.size();
+            lens.push_back(len);
+            m_max_len = std::max(m_max_len, len);
+            histograms.emplace_back(s);
+
+#ifdef RAPIDFUZZ_SIMD
+            auto& bucket = buckets[bucket_index(detail::length_bucket_width(len))];
+#else
+            auto& bucket = buckets[4];
+#endif
+            if (bucket.indices.empty()) {
+                bucket.min_len = len;
+                bucket.max_len = len;
+            }
+            bucket.min_len = std::min(bucket.min_len, len);
+            bucket.max_len = std::max(bucket.max_len, len);
+            bucket.indices.push_back(idx);
+        }
+
+#ifdef RAPIDFUZZ_SIMD
+        multi8 = init_multi<8>(first);
+        multi16 = init_multi<16>(first);
+        multi32 = init_multi<32>(first);
+        multi64 = init_multi<64>(first);
+#endif
+
+        auto& long_bucket = buckets[4];
+        long_strings.reserve(long_bucket.indices.size());
+        for (size_t i : long_bucket.indices) {
+            auto s = detail::Range(first[static_cast<ptrdiff_t>(i)]);
+            long_strings.emplace_back(s.begin(), s.end());
+        }
+    }
+
+    size_t size() const noexcept
+    {
+        return input_count;
+    }
+
+    /**
+     * @brief number of strings in the bucket for strings up to MaxLen characters
+     * (MaxLen = 0 for the strings scored by the Cached* scorers)
+     */
+    size_t bucket_size(size_t max_len) const
+    {
+        return buckets[bucket_index(max_len)].indices.size();
+    }
+
+    /**
+     * @brief number of buckets skipped based on the prefilters in the last call
+     */
+    size_t skipped_buckets() const noexcept
+    {
+        return m_skipped_buckets;
+    }
+
+    /**
+     * @brief number of candidates rejected by each prefilter in the last call
+     */
+    const PrefilterStats& prefilter_stats() const noexcept
+    {
+        return m_stats;
+    }
+
+    template <typename Sentence2>
+    void distance(ResType* scores, size_t score_count, const Sentence2& s2,
+                  ResType score_cutoff = worst_distance()) const
+    {
+        auto s2_ = detail::Range(s2);
+        ResType skip_score = std::is_floating_point_v<ResType> ? ResType(1) : score_cutoff + 1;
+        auto can_skip = [&](size_t len1, size_t hist_diff) {
+            return Metric::Bound::distance(len1, s2_.size(), hist_diff) > score_cutoff;
+        };
+        score(scores, score_count, s2_, skip_score, can_skip, [&](const auto& scorer, auto* out, size_t count) {
+            scorer.distance(out, count, s2_, score_cutoff);
+        }, [&](const auto& cached, const auto& s1) {
+            return cached.distance(s1, score_cutoff);
+        });
+    }
+
+    template <typename Sentence2>
+    void similarity(ResType* scores, size_t score_count, const Sentence2& s2, ResType score_cutoff = 0) const
+    {
+        auto s2_ = detail::Range(s2);
+        score(scores, score_count, s2_, ResType(0), [](size_t, size_t) { return false; },
+              [&](const auto& scorer, auto* out, size_t count) {
+                  scorer.similarity(out, count, s2_, score_cutoff);
+              },
+              [&](const auto& cached, const auto& s1) {
+                  return cached.similarity(s1, score_cutoff);
+              });
+    }
+
+    template <typename Sentence2>
+    void normalized_distance(double* scores, size_t score_count, const Sentence2& s2,
+                             double score_cutoff = 1.0) const
+    {
+        auto s2_ = detail::Range(s2);
+        auto can_skip = [&](size_t len1, size_t hist_diff) {
+            return Metric::Bound::normalized_distance(len1, s2_.size(), hist_diff) > score_cutoff;
+        };
+        score(scores, score_count, s2_, 1.0, can_skip,
+              [&](const auto& scorer, auto* out, size_t count) {
+                  scorer.normalized_distance(out, count, s2_, score_cutoff);
+              },
+              [&](const auto& cached, const auto& s1) {
+                  return cached.normalized_distance(s1, score_cutoff);
+              });
+    }
+
+    template <typename Sentence2>
+    void normalized_similarity(double* scores, size_t score_count, const Sentence2& s2,
+                               double score_cutoff = 0.0) const
+    {
+        auto s2_ = detail::Range(s2);
+        auto can_skip = [&](size_t len1, size_t hist_diff) {
+            return 1.0 - Metric::Bound::normalized_distance(len1, s2_.size(), hist_diff) < score_cutoff;
+        };
+        score(scores, score_count, s2_, 0.0, can_skip,
+              [&](const auto& scorer, auto* out, size_t count) {
+                  scorer.normalized_similarity(out, count, s2_, score_cutoff);
+              },
+              [&](const auto& cached, const auto& s1) {
+                  return cached.normalized_similarity(s1, score_cutoff);
+              });
+    }
+
+    /**
+     * @brief normalized similarity as fixed point number between 0 and 10000 (rounded down),
+     * which is 0 for scores below score_cutoff. Only supported by the metrics with an integer
+     * distance. The score_cutoff is converted into a distance cutoff per string length, so
+     * neither the prefilters nor the conversion of the scores use floating point
+     */
+    template <typename Sentence2>
+    void fixed_point_similarity(uint16_t* scores, size_t score_count, const Sentence2& s2,
+                                uint16_t score_cutoff = 0) const
+    {
+        static_assert(std::is_integral_v<ResType>, "fixed point scores require an integer distance");
+        if (score_count < input_count) throw std::invalid_argument("scores has to have >= size() elements");
+
+        auto s2_ = detail::Range(s2);
+        size_t len2 = s2_.size();
+        auto max_distance = [&](size_t len1) {
+            return detail::fixed_point_max_distance(Metric::Bound::maximum(len1, len2), score_cutoff);
+        };
+        auto can_skip = [&](size_t len1, size_t hist_diff) {
+            return Metric::Bound::distance(len1, len2, hist_diff) > max_distance(len1);
+        };
+
+        /* the SIMD scorers share one cutoff, which is the loosest one of all lengths */
+        size_t multi_cutoff = max_distance(std::min<size_t>(m_max_len, 64));
+        std::vector<ResType> dists(input_count);
+        score(dists.data(), dists.size(), s2_, std::numeric_limits<ResType>::max(), can_skip,
+              [&](const auto& scorer, auto* out, size_t count) {
+                  scorer.distance(out, count, s2_, multi_cutoff);
+              },
+              [&](const auto& cached, const auto& s1) {
+                  return cached.distance(s1, max_distance(s1.size()));
+              });
+
+        for (size_t i = 0; i < input_count; ++i) {
+            size_t maximum = Metric::Bound::maximum(lens[i], len2);
+            scores[i] = (dists[i] <= detail::fixed_point_max_distance(maximum, score_cutoff))
+                            ? detail::fixed_point_similarity(maximum, dists[i])
+                            : 0;
+        }
+    }
+
+private:
+    struct Bucket {
+        size_t min_len = 0;
+        size_t max_len = 0;
+        std::vector<size_t> indices;
+    };
+
+    static constexpr ResType worst_distance()
+    {
+        if constexpr (std::is_floating_point_v<ResType>)
+            return ResType(1);
+        else
+            return std::numeric_limits<ResType>::max();
+    }
+
+    static size_t bucket_index(size_t width)
+    {
+        switch (width) {
+        case 8: return 0;
+        case 16: return 1;
+        case 32: return 2;
+        case 64: return 3;
+        default: return 4;
+        }
+    }
+
+    /* rejects all candidates of a bucket when even its closest length can not reach the score_cutoff */
+    template <typename SkipFunc>
+    bool skip_bucket(const Bucket& bucket, size_t len2, SkipFunc&& can_skip) const
+    {
+        if (!can_skip(detail::closest_length(bucket.min_len, bucket.max_len, len2), 0)) return false;
+
+        m_skipped_buckets++;
+        m_stats.length += bucket.indices.size();
+        return true;
+    }
+
+    /* runs the length and histogram prefilter for a single candidate */
+    template <typename SkipFunc>
+    bool reject(size_t idx, const detail::CharHistogram& hist2, SkipFunc&& can_skip) const
+    {
+        if (can_skip(lens[idx], 0)) {
+            m_stats.length++;
+            return true;
+        }
+
+        if (can_skip(lens[idx], histograms[idx].l1_distance(hist2))) {
+            m_stats.histogram++;
+            return true;
+        }
+
+        m_stats.scored++;
+        return false;
+    }
+
+#ifdef RAPIDFUZZ_SIMD
+    template <int MaxLen, typename InputIt>
+    auto init_multi(InputIt first) const
+    {
+        const auto& bucket = buckets[bucket_index(MaxLen)];
+        std::unique_ptr<typename Metric::template Multi<MaxLen>> scorer;
+        if (bucket.indices.empty()) return scorer;
+
+        scorer = metric.template make_multi<MaxLen>(bucket.indices.size());
+        for (size_t i : bucket.indices)
+            scorer->insert(first[static_cast<ptrdiff_t>(i)]);
+        return scorer;
+    }
+
+    template <int MaxLen, typename T, typename InputIt2, typename SkipFunc, typename MultiFunc>
+    void score_bucket(T* scores, const std::unique_ptr<typename Metric::template Multi<MaxLen>>& scorer,
+                      const detail::Range<InputIt2>& s2, const detail::CharHistogram& hist2, T skip_score,
+                      SkipFunc&& can_skip, MultiFunc&& multi_func) const
+    {
+        const auto& bucket = buckets[bucket_index(MaxLen)];
+        if (!scorer) return;
+
+        if (skip_bucket(bucket, s2.size(), can_skip)) {
+            for (size_t i : bucket.indices)
+                scores[i] = skip_score;
+            return;
+        }
+
+        /* candidates share SIMD lanes, so the bucket is scored as soon as one of them survives */
+        std::vector<bool> rejected(bucket.indices.size());
+        bool any_survivor = false;
+        for (size_t i = 0; i < bucket.indices.size(); ++i) {
+            rejected[i] = reject(bucket.indices[i], hist2, can_skip);
+            any_survivor |= !rejected[i];
+        }
+
+        if (!any_survivor) {
+            m_skipped_buckets++;
+            for (size_t i : bucket.indices)
+                scores[i] = skip_score;
+            return;
+        }
+
+        std::vector<T> results(scorer->result_count());
+        multi_func(*scorer, results.data(), results.size());
+        for (size_t i = 0; i < bucket.indices.size(); ++i)
+            scores[bucket.indices[i]] = rejected[i] ? skip_score : results[i];
+    }
+#endif
+
+    template <typename T, typename InputIt2, typename SkipFunc, typename MultiFunc, typename CachedFunc>
+    void score(T* scores, size_t score_count, const detail::Range<InputIt2>& s2, T skip_score,
+               SkipFunc&& can_skip, MultiFunc&& multi_func, CachedFunc&& cached_func) const
+    {
+        if (score_count < input_count) throw std::invalid_argument("scores has to have >= size() elements");
+
+        m_skipped_buckets = 0;
+        m_stats = PrefilterStats();
+        detail::CharHistogram hist2(s2);
+
+#ifdef RAPIDFUZZ_SIMD
+        score_bucket<8>(scores, multi8, s2, hist2, skip_score, can_skip, multi_func);
+        score_bucket<16>(scores, multi16, s2, hist2, skip_score, can_skip, multi_func);
+        score_bucket<32>(scores, multi32, s2, hist2, skip_score, can_skip, multi_func);
+        score_bucket<64>(scores, multi64, s2, hist2, skip_score, can_skip, multi_func);
+#else
+        (void)multi_func;
+#endif
+
+        const auto& long_bucket = buckets[4];
+        if (long_bucket.indices.empty()) return;
+
+        if (skip_bucket(long_bucket, s2.size(), can_skip)) {
+            for (size_t i : long_bucket.indices)
+                scores[i] = skip_score;
+            return;
+        }
+
+        /* all supported metrics are symmetric, so the cached scorer is built for s2 once */
+        std::optional<decltype(metric.make_cached(s2))> cached;
+        for (size_t i = 0; i < long_bucket.indices.size(); ++i) {
+            size_t idx = long_bucket.indices[i];
+            if (reject(idx, hist2, can_skip)) {
+                scores[idx] = skip_score;
+                continue;
+            }
+
+            if (!cached) cached.emplace(metric.make_cached(s2));
+            scores[idx] = cached_func(*cached, long_strings[i]);
+        }
+    }
+
+    Metric metric;
+    size_t input_count = 0;
+    std::array<Bucket, 5> buckets;
+    std::vector<size_t> lens;
+    size_t m_max_len = 0;
+    std::vector<detail::CharHistogram> histograms;
+    std::vector<std::vector<CharT1>> long_strings;
+    mutable size_t m_skipped_buckets = 0;
+    mutable PrefilterStats m_stats;
+#ifdef RAPIDFUZZ_SIMD
+    std::unique_ptr<typename Metric::template Multi<8>> multi8;
+    std::unique_ptr<typename Metric::template Multi<16>> multi16;
+    std::unique_ptr<typename Metric::template Multi<32>> multi32;
+    std::unique_ptr<typename Metric::template Multi<64>> multi64;
+#endif
+};
+
+/**
+ * @brief choices preprocessed once for scoring many queries with WRatio
+ *
+ * Besides the strings and their character histograms this keeps the token
+ * forms WRatio needs in its token_ratio and partial_token_ratio stages (the
+ * sorted joins and the token sets), which CachedWRatio recomputes from the
+ * choice for every comparison. Use WRatioQuery to score a query against it.
+ */
+template <typename CharT1>
+class BatchWRatio {
+public:
+    template <typename Sentence1>
+    explicit BatchWRatio(const std::vector<Sentence1>& strings) : BatchWRatio(strings.begin(), strings.end())
+    {}
+
+    template <typename InputIt>
+    BatchWRatio(InputIt first, InputIt last) : tokens(first, last)
+    {
+        offsets.push_back(0);
+        for (auto it = first; it != last; ++it) {
+            auto s = detail::Range(*it);
+            chars.insert(chars.end(), s.begin(), s.end());
+            offsets.push_back(chars.size());
+            histograms.emplace_back(s);
+        }
+    }
+
+    size_t size() const
+    {
+        return histograms.size();
+    }
+
+    detail::Range<const CharT1*> string(size_t i) const
+    {
+        return detail::Range(chars.data() + offsets[i], chars.data() + offsets[i + 1]);
+    }
+
+private:
+    template <typename>
+    friend class WRatioQuery;
+
+    experimental::TokenizedChoices<CharT1> tokens;
+    std::vector<CharT1> chars;
+    std::vector<size_t> offsets;
+    std::vector<detail::CharHistogram> histograms;
+};
+
+template <typename Sentence1>
+explicit BatchWRatio(const std::vector<Sentence1>& strings) -> BatchWRatio<char_type<Sentence1>>;
+
+/**
+ * @brief WRatio of one query against the choices of a BatchWRatio
+ *
+ * Returns the same scores as fuzz::WRatio. Every stage of WRatio is weighted
+ * with a scale that only depends on the length ratio of the two strings, so
+ * before a stage runs its best possible contribution is compared with the
+ * score_cutoff and the best score found so far:
+ *  - the ratio stage is skipped when the length and character histogram bound
+ *    of the ratio can not reach the score_cutoff
+ *  - the partial_ratio stage is skipped when it can not reach
+ *    score_cutoff / PARTIAL_SCALE
+ *  - the token stages are skipped when they can not reach
+ *    score_cutoff / (UNBASE_SCALE * PARTIAL_SCALE)
+ * The token stages use the token forms precomputed in BatchWRatio, so the
+ * choice is never split or sorted again.
+ *
+ * An instance reuses internal buffers and must not be used by multiple
+ * threads at once.
+ */
+template <typename CharT1>
+class WRatioQuery {
+public:
+    template <typename Sentence2>
+    WRatioQuery(const BatchWRatio<CharT1>& choices_, const Sentence2& s2)
+        : choices(&choices_),
+          s1(detail::to_begin(s2), detail::to_end(s2)),
+          hist1(detail::Range(s1)),
+          cached_partial_ratio(s1),
+          cached_ratio(s1),
+          token_query(choices_.tokens, s1)
+    {}
+
+    double similarity(size_t i, double score_cutoff = 0.0) const
+    {
+        using fuzz::fuzz_detail::ratio_upper_bound;
+
+        if (score_cutoff > 100) return 0;
+
+        constexpr double UNBASE_SCALE = 0.95;
+
+        auto s2 = choices->string(i);
+        size_t len1 = s1.size();
+        size_t len2 = s2.size();
+
+        /* in FuzzyWuzzy this returns 0. For sake of compatibility return 0 here as well
+         * see https://github.com/rapidfuzz/RapidFuzz/issues/110 */
+        if (!len1 || !len2) return 0;
+
+        double len_ratio = (len1 > len2) ? static_cast<double>(len1) / static_cast<double>(len2)
+                                         : static_cast<double>(len2) / static_cast<double>(len1);
+
+        /* ratio returns 0 for scores below the score_cutoff */
+        double end_ratio = 0;
+        if (ratio_upper_bound(len1, len2, hist1.l1_distance(choices->histograms[i])) >= score_cutoff)
+            end_ratio = cached_ratio.similarity(s2, score_cutoff);
+
+        if (len_ratio < 1.5) {
+            score_cutoff = std::max(score_cutoff, end_ratio) / UNBASE_SCALE;
+            if (score_cutoff > 100) return end_ratio;
+            return std::max(end_ratio, token_query.token_ratio(i, score_cutoff) * UNBASE_SCALE);
+        }
+
+        const double PARTIAL_SCALE = (len_ratio < 8.0) ? 0.9 : 0.6;
+
+        score_cutoff = std::max(score_cutoff, end_ratio) / PARTIAL_SCALE;
+        if (score_cutoff > 100) return end_ratio;
+        end_ratio = std::max(end_ratio, cached_partial_ratio.similarity(s2, score_cutoff) * PARTIAL_SCALE);
+
+        score_cutoff = std::max(score_cutoff, end_ratio) / UNBASE_SCALE;
+        if (score_cutoff > 100) return end_ratio;
+        return std::max(end_ratio,
+                        token_query.partial_token_ratio(i, score_cutoff) * UNBASE_SCALE * PARTIAL_SCALE);
+    }
+
+private:
+    const BatchWRatio<CharT1>* choices;
+    std::vector<CharT1> s1;
+    detail::CharHistogram hist1;
+    fuzz::CachedPartialRatio<CharT1> cached_partial_ratio;
+    fuzz::CachedRatio<CharT1> cached_ratio;
+    experimental::TokenQuery<CharT1> token_query;
+};
+
+} // namespace experimental
+} // namespace rapidfuzz
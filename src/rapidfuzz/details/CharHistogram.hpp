@@ -0,0 +1,108 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright © 2022-present Max Bachmann */
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <rapidfuzz/details/Range.hpp>
+#include <rapidfuzz/details/common.hpp>
+#include <rapidfuzz/details/simd.hpp>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace rapidfuzz::detail {
+
+/**
+ * @brief compact character histogram used to calculate cheap lower bounds
+ * for edit distances before running the bit-parallel kernels
+ *
+ * Characters are hashed into 64 bins and the counts saturate at 255. Both
+ * only make the L1 difference between two histograms smaller, so it stays a
+ * lower bound for the L1 difference of the exact character counts.
+ */
+struct CharHistogram {
+    static constexpr size_t bin_count = 64;
+
+    CharHistogram()
+    {
+        bins.fill(0);
+    }
+
+    template <typename InputIt>
+    explicit CharHistogram(const Range<InputIt>& s) : CharHistogram()
+    {
+        for (const auto& ch : s) {
+            uint8_t& count = bins[bin(static_cast<uint64_t>(ch))];
+            count = static_cast<uint8_t>(count + (count != 255));
+        }
+    }
+
+    static constexpr size_t bin(uint64_t ch)
+    {
+        return static_cast<size_t>((ch ^ (ch >> 6) ^ (ch >> 12)) % bin_count);
+    }
+
+    /**
+     * @brief L1 difference between two histograms
+     */
+    size_t l1_distance(const CharHistogram& other) const
+    {
+        size_t dist = 0;
+#if defined(RAPIDFUZZ_AVX2)
+        for (size_t i = 0; i < bin_count; i += 32) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bins.data() + i));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(other.bins.data() + i));
+            __m256i sad = _mm256_sad_epu8(a, b);
+            dist += static_cast<size_t>(_mm256_extract_epi64(sad, 0) + _mm256_extract_epi64(sad, 1) +
+                                        _mm256_extract_epi64(sad, 2) + _mm256_extract_epi64(sad, 3));
+        }
+#elif defined(RAPIDFUZZ_SSE2)
+        for (size_t i = 0; i < bin_count; i += 16) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bins.data() + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(other.bins.data() + i));
+            __m128i sad = _mm_sad_epu8(a, b);
+            dist += static_cast<size_t>(_mm_cvtsi128_si32(sad) + _mm_extract_epi16(sad, 4));
+        }
+#else
+        for (size_t i = 0; i < bin_count; ++i)
+            dist += static_cast<size_t>(std::abs(static_cast<int>(bins[i]) - static_cast<int>(other.bins[i])));
+#endif
+        return dist;
+    }
+
+    std::array<uint8_t, bin_count> bins;
+};
+
+/**
+ * @brief lower bound for the Indel distance
+ *
+ * every inserted or deleted character changes the histogram by exactly one
+ */
+static inline size_t indel_lower_bound(size_t len1, size_t len2, size_t hist_diff = 0)
+{
+    return std::max(abs_diff(len1, len2), hist_diff);
+}
+
+/**
+ * @brief lower bound for the uniform Levenshtein, OSA and LCSseq distance
+ *
+ * a substitution changes the histogram by at most two, while insertions and
+ * deletions change it by one and the length by one as well
+ */
+static inline size_t levenshtein_lower_bound(size_t len1, size_t len2, size_t hist_diff = 0)
+{
+    size_t len_diff = abs_diff(len1, len2);
+    return std::max(len_diff, (hist_diff + len_diff + 1) / 2);
+}
+
+/**
+ * @brief upper bound for the number of matching characters in the Jaro similarity
+ */
+static inline size_t jaro_match_upper_bound(size_t len1, size_t len2, size_t hist_diff = 0)
+{
+    size_t common = (len1 + len2 - std::min(hist_diff, len1 + len2)) / 2;
+    return std::min(std::min(len1, len2), common);
+}
+
+} // namespace rapidfuzz::detail
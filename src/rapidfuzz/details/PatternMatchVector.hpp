@@ -2,60 +2,154 @@
 /* Copyright (c) 2022 Max Bachmann */
 
 #pragma once
+#include <algorithm>
 #include <array>
 #include <stdint.h>
 #include <stdio.h>
+#include <vector>
 
 #include <rapidfuzz/details/GrowingHashmap.hpp>
 #include <rapidfuzz/details/Matrix.hpp>
 #include <rapidfuzz/details/Range.hpp>
 #include <rapidfuzz/details/intrinsics.hpp>
+#include <rapidfuzz/details/simd.hpp>
 
 namespace rapidfuzz::detail {
 
+/**
+ * @brief map from characters above 255 to their bit vector in one block of 64 characters.
+ *
+ * The 128 slots form groups of 16 (SSE2) or 8 (scalar) slots. Every slot has a control
+ * byte holding 7 bits of the hash of its key, or EMPTY, and a lookup compares the control
+ * bytes of a whole group at once, so keys are only compared for slots whose hash bits
+ * match. A block holds at most 64 characters, so the table is never more than half full
+ * and probing stops at the first group with an empty slot.
+ */
 struct BitvectorHashmap {
-    BitvectorHashmap() : m_map()
-    {}
+    BitvectorHashmap() noexcept : m_keys(), m_values()
+    {
+        m_ctrl.fill(UINT64_C(0x0101010101010101) * EMPTY);
+    }
 
     template <typename CharT>
     uint64_t get(CharT key) const noexcept
     {
-        return m_map[lookup(static_cast<uint64_t>(key))].value;
+        size_t i = find(static_cast<uint64_t>(key));
+        return (i < SLOTS) ? m_values[i] : 0;
     }
 
     template <typename CharT>
     uint64_t& operator[](CharT key) noexcept
     {
-        uint32_t i = lookup(static_cast<uint64_t>(key));
-        m_map[i].key = static_cast<uint64_t>(key);
-        return m_map[i].value;
+        uint64_t k = static_cast<uint64_t>(key);
+        size_t i = find(k);
+        if (i < SLOTS) return m_values[i];
+
+        uint64_t h = hash(k);
+        size_t group = hash_group(h);
+        for (size_t probe = 0; probe < GROUPS; ++probe, group = (group + 1) % GROUPS) {
+            uint64_t empty = match_empty(group);
+            if (empty) {
+                i = group * GROUP_SIZE + (countr_zero(empty) >> SLOT_SHIFT);
+                set_ctrl(i, hash_tag(h));
+                m_keys[i] = k;
+                return m_values[i];
+            }
+        }
+
+        /* unreachable since the table is at most half full */
+        assert(false);
+        return m_values[0];
     }
 
 private:
-    /**
-     * lookup key inside the hashmap using a similar collision resolution
-     * strategy to CPython and Ruby
-     */
-    uint32_t lookup(uint64_t key) const noexcept
+#if defined(RAPIDFUZZ_SSE2) || defined(RAPIDFUZZ_AVX2)
+    /* one bit per slot in the masks of _mm_movemask_epi8 */
+    static constexpr size_t GROUP_SIZE = 16;
+    static constexpr unsigned SLOT_SHIFT = 0;
+#else
+    /* the high bit of every byte in the masks of a 64 bit word */
+    static constexpr size_t GROUP_SIZE = 8;
+    static constexpr unsigned SLOT_SHIFT = 3;
+#endif
+    static constexpr size_t SLOTS = 128;
+    static constexpr size_t GROUPS = SLOTS / GROUP_SIZE;
+    static constexpr uint64_t EMPTY = 0x80;
+
+    static uint64_t hash(uint64_t key) noexcept
+    {
+        return key * UINT64_C(0x9E3779B97F4A7C15);
+    }
+
+    static size_t hash_group(uint64_t h) noexcept
+    {
+        return static_cast<size_t>(h >> 57) % GROUPS;
+    }
+
+    static uint64_t hash_tag(uint64_t h) noexcept
+    {
+        return (h >> 50) & 0x7F;
+    }
+
+    void set_ctrl(size_t i, uint64_t tag) noexcept
+    {
+        unsigned shift = static_cast<unsigned>(i % 8) * 8;
+        m_ctrl[i / 8] = (m_ctrl[i / 8] & ~(UINT64_C(0xFF) << shift)) | (tag << shift);
+    }
+
+#if defined(RAPIDFUZZ_SSE2) || defined(RAPIDFUZZ_AVX2)
+    __m128i load_group(size_t group) const noexcept
+    {
+        return _mm_load_si128(reinterpret_cast<const __m128i*>(&m_ctrl[group * 2]));
+    }
+
+    uint64_t match(size_t group, uint64_t tag) const noexcept
+    {
+        __m128i tag_vec = _mm_set1_epi8(static_cast<char>(tag));
+        return static_cast<uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(load_group(group), tag_vec)));
+    }
+
+    /* tags never have the high bit set */
+    uint64_t match_empty(size_t group) const noexcept
+    {
+        return static_cast<uint64_t>(_mm_movemask_epi8(load_group(group)));
+    }
+#else
+    uint64_t match(size_t group, uint64_t tag) const noexcept
     {
-        uint32_t i = key % 128;
+        constexpr uint64_t low7 = UINT64_C(0x7F7F7F7F7F7F7F7F);
+        uint64_t v = m_ctrl[group] ^ (UINT64_C(0x0101010101010101) * tag);
+        return ~(((v & low7) + low7) | v | low7);
+    }
 
-        if (!m_map[i].value || m_map[i].key == key) return i;
+    uint64_t match_empty(size_t group) const noexcept
+    {
+        return m_ctrl[group] & UINT64_C(0x8080808080808080);
+    }
+#endif
 
-        uint64_t perturb = key;
-        while (true) {
-            i = (static_cast<uint64_t>(i) * 5 + perturb + 1) % 128;
-            if (!m_map[i].value || m_map[i].key == key) return i;
+    size_t find(uint64_t key) const noexcept
+    {
+        uint64_t h = hash(key);
+        uint64_t tag = hash_tag(h);
+        size_t group = hash_group(h);
+
+        for (size_t probe = 0; probe < GROUPS; ++probe, group = (group + 1) % GROUPS) {
+            for (uint64_t matches = match(group, tag); matches; matches = blsr(matches)) {
+                size_t i = group * GROUP_SIZE + (countr_zero(matches) >> SLOT_SHIFT);
+                if (m_keys[i] == key) return i;
+            }
 
-            perturb >>= 5;
+            if (match_empty(group)) break;
         }
+
+        return SLOTS;
     }
 
-    struct MapElem {
-        uint64_t key = 0;
-        uint64_t value = 0;
-    };
-    std::array<MapElem, 128> m_map;
+    /* control bytes, 8 per word */
+    alignas(16) std::array<uint64_t, SLOTS / 8> m_ctrl;
+    std::array<uint64_t, SLOTS> m_keys;
+    std::array<uint64_t, SLOTS> m_values;
 };
 
 struct PatternMatchVector {
@@ -112,6 +206,15 @@ struct PatternMatchVector {
         return get(key);
     }
 
+    /**
+     * @brief bit vector of one character, indexed by block like BlockPatternMatchVector::row
+     */
+    template <typename CharT>
+    std::array<uint64_t, 1> row(CharT key) const noexcept
+    {
+        return {get(key)};
+    }
+
     void insert_mask(char key, uint64_t mask) noexcept
     {
         /** treat char as value between 0 and 127 for performance reasons */
@@ -132,12 +235,26 @@ private:
     std::array<uint64_t, 256> m_extendedAscii;
 };
 
+/**
+ * @brief bit vectors of the positions of every character in a string of any length.
+ *
+ * Characters up to 255 are mapped to dense rows by a 256 entry lookup table, so only
+ * the characters that occur in the string take up a row of bit vectors. Row 0 is all
+ * zeros and is never handed out, so it is shared by the bytes that do not occur and
+ * by characters above 255 when there is no hashmap, even if all 256 bytes occur.
+ *
+ * The storage can be reused for another string with reset(), which only allocates
+ * when the string needs more memory than any string stored before. The hashmaps for
+ * characters above 255 are allocated on the first such character and are only cleared
+ * once a string containing such a character is inserted after a reset.
+ */
 struct BlockPatternMatchVector {
     BlockPatternMatchVector() = delete;
 
-    BlockPatternMatchVector(size_t str_len)
-        : m_block_count(ceil_div(str_len, 64)), m_map(nullptr), m_extendedAscii(256, m_block_count, 0)
-    {}
+    BlockPatternMatchVector(size_t str_len) : m_block_count(ceil_div(str_len, 64)), m_map(nullptr)
+    {
+        clear_rows();
+    }
 
     template <typename InputIt>
     BlockPatternMatchVector(const Range<InputIt>& s) : BlockPatternMatchVector(s.size())
@@ -145,11 +262,83 @@ struct BlockPatternMatchVector {
         insert(s);
     }
 
+    BlockPatternMatchVector(const BlockPatternMatchVector& other)
+        : m_block_count(other.m_block_count),
+          m_map(nullptr),
+          m_map_active(other.m_map_active),
+          m_row(other.m_row),
+          m_rows(other.m_rows),
+          m_bits(other.m_bits)
+    {
+        if (m_map_active) {
+            m_map = new BitvectorHashmap[m_block_count];
+            m_map_capacity = m_block_count;
+            std::copy_n(other.m_map, m_block_count, m_map);
+        }
+    }
+
+    BlockPatternMatchVector(BlockPatternMatchVector&& other) noexcept : BlockPatternMatchVector(size_t(0))
+    {
+        other.swap(*this);
+    }
+
+    BlockPatternMatchVector& operator=(BlockPatternMatchVector&& other) noexcept
+    {
+        other.swap(*this);
+        return *this;
+    }
+
+    BlockPatternMatchVector& operator=(const BlockPatternMatchVector& other)
+    {
+        BlockPatternMatchVector temp = other;
+        temp.swap(*this);
+        return *this;
+    }
+
+    void swap(BlockPatternMatchVector& rhs) noexcept
+    {
+        using std::swap;
+        swap(m_block_count, rhs.m_block_count);
+        swap(m_map, rhs.m_map);
+        swap(m_map_capacity, rhs.m_map_capacity);
+        swap(m_map_active, rhs.m_map_active);
+        swap(m_row, rhs.m_row);
+        swap(m_rows, rhs.m_rows);
+        swap(m_bits, rhs.m_bits);
+    }
+
     ~BlockPatternMatchVector()
     {
         delete[] m_map;
     }
 
+    /**
+     * @brief clears the bit vectors and resizes them for a string of length str_len
+     * without freeing their memory
+     */
+    void reset(size_t str_len)
+    {
+        m_block_count = ceil_div(str_len, 64);
+        clear_rows();
+        m_map_active = false;
+    }
+
+    template <typename InputIt>
+    void reset(const Range<InputIt>& s)
+    {
+        reset(s.size());
+        insert(s);
+    }
+
+    /**
+     * @brief number of rows of bit vectors, which is the number of distinct
+     * characters up to 255 in the string plus the row of zeros
+     */
+    size_t alphabet_rows() const noexcept
+    {
+        return m_rows;
+    }
+
     size_t size() const noexcept
     {
         return m_block_count;
@@ -185,9 +374,9 @@ struct BlockPatternMatchVector {
     {
         assert(block < size());
         if (key >= 0 && key <= 255)
-            m_extendedAscii[static_cast<uint8_t>(key)][block] |= mask;
+            m_bits[row_for_insert(static_cast<uint8_t>(key)) * m_block_count + block] |= mask;
         else {
-            if (!m_map) m_map = new BitvectorHashmap[m_block_count];
+            if (!m_map_active) activate_map();
             m_map[block][key] |= mask;
         }
     }
@@ -201,8 +390,8 @@ struct BlockPatternMatchVector {
     uint64_t get(size_t block, CharT key) const noexcept
     {
         if (key >= 0 && key <= 255)
-            return m_extendedAscii[static_cast<uint8_t>(key)][block];
-        else if (m_map)
+            return m_bits[m_row[static_cast<uint8_t>(key)] * m_block_count + block];
+        else if (m_map_active)
             return m_map[block].get(key);
         else
             return 0;
@@ -213,10 +402,88 @@ struct BlockPatternMatchVector {
         return get(block, static_cast<uint8_t>(ch));
     }
 
+    /**
+     * @brief bit vectors of one character in all blocks. Kernels iterating over
+     * the blocks for the same character look the character up only once. Bytes
+     * get a plain pointer to their row, so the kernels do not branch per block
+     */
+    class Row {
+    public:
+        Row(const uint64_t* bits, const BitvectorHashmap* map, uint64_t key) noexcept
+            : m_bits(bits), m_map(map), m_key(key)
+        {}
+
+        uint64_t operator[](size_t block) const noexcept
+        {
+            if (m_map) return m_map[block].get(m_key);
+            return m_bits[block];
+        }
+
+    private:
+        const uint64_t* m_bits;
+        const BitvectorHashmap* m_map;
+        uint64_t m_key;
+    };
+
+    template <typename CharT>
+    Row row(CharT key) const noexcept
+    {
+        if (key >= 0 && key <= 255) return Row(&m_bits[m_row[static_cast<uint8_t>(key)] * m_block_count], nullptr, 0);
+        /* characters above 255 without any hashmap read the zero row */
+        if (!m_map_active) return Row(m_bits.data(), nullptr, 0);
+        return Row(nullptr, m_map, static_cast<uint64_t>(key));
+    }
+
+    const uint64_t* row(uint8_t key) const noexcept
+    {
+        return &m_bits[m_row[key] * m_block_count];
+    }
+
+    const uint64_t* row(char key) const noexcept
+    {
+        return row(static_cast<uint8_t>(key));
+    }
+
 private:
+    void clear_rows()
+    {
+        m_row.fill(0);
+        m_rows = 1;
+        m_bits.assign(m_block_count, 0);
+    }
+
+    size_t row_for_insert(uint8_t key)
+    {
+        size_t row = m_row[key];
+        if (row != 0) return row;
+
+        m_row[key] = static_cast<uint16_t>(m_rows);
+        m_bits.resize((m_rows + 1) * m_block_count, 0);
+        return m_rows++;
+    }
+
+    void activate_map()
+    {
+        if (m_map_capacity < m_block_count) {
+            auto* map = new BitvectorHashmap[m_block_count];
+            delete[] m_map;
+            m_map = map;
+            m_map_capacity = m_block_count;
+        }
+        else {
+            std::fill_n(m_map, m_block_count, BitvectorHashmap());
+        }
+        m_map_active = true;
+    }
+
     size_t m_block_count;
     BitvectorHashmap* m_map;
-    BitMatrix<uint64_t> m_extendedAscii;
+    size_t m_map_capacity = 0;
+    bool m_map_active = false;
+    /* row of every byte, up to 256 rows after the zero row */
+    std::array<uint16_t, 256> m_row;
+    size_t m_rows;
+    std::vector<uint64_t> m_bits;
 };
 
 } // namespace rapidfuzz::detail
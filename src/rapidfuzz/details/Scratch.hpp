@@ -0,0 +1,195 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright (c) 2022 Max Bachmann */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <stddef.h>
+#include <vector>
+
+namespace rapidfuzz {
+
+/**
+ * @brief number of scratch buffers requested by the scorers, how many of the
+ * requests had to allocate because no buffer of the thread was large enough,
+ * and the number of bytes these allocations added
+ */
+struct ScratchStats {
+    size_t requests = 0;
+    size_t allocations = 0;
+    size_t bytes = 0;
+};
+
+namespace detail {
+
+/**
+ * @brief counters of one thread. Only the owning thread writes them, so plain
+ * relaxed loads and stores are enough, while other threads can read them at any time
+ */
+struct ScratchCounters {
+    std::atomic<size_t> requests{0};
+    std::atomic<size_t> allocations{0};
+    std::atomic<size_t> bytes{0};
+
+    static void add(std::atomic<size_t>& counter, size_t value) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief counters of all threads, including the threads that already exited
+ */
+class ScratchRegistry {
+public:
+    static ScratchRegistry& instance()
+    {
+        static ScratchRegistry registry;
+        return registry;
+    }
+
+    void attach(ScratchCounters* counters)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_threads.push_back(counters);
+    }
+
+    void detach(ScratchCounters* counters)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_retired.requests += counters->requests.load(std::memory_order_relaxed);
+        m_retired.allocations += counters->allocations.load(std::memory_order_relaxed);
+        m_retired.bytes += counters->bytes.load(std::memory_order_relaxed);
+        m_threads.erase(std::remove(m_threads.begin(), m_threads.end(), counters), m_threads.end());
+    }
+
+    ScratchStats stats()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ScratchStats total = m_retired;
+        for (const auto* counters : m_threads) {
+            total.requests += counters->requests.load(std::memory_order_relaxed);
+            total.allocations += counters->allocations.load(std::memory_order_relaxed);
+            total.bytes += counters->bytes.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    /* only exact while no other thread is scoring */
+    void reset()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_retired = ScratchStats();
+        for (auto* counters : m_threads) {
+            counters->requests.store(0, std::memory_order_relaxed);
+            counters->allocations.store(0, std::memory_order_relaxed);
+            counters->bytes.store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    std::mutex m_mutex;
+    std::vector<ScratchCounters*> m_threads;
+    ScratchStats m_retired;
+};
+
+struct ThreadScratchCounters {
+    ThreadScratchCounters()
+    {
+        ScratchRegistry::instance().attach(&counters);
+    }
+
+    ~ThreadScratchCounters()
+    {
+        ScratchRegistry::instance().detach(&counters);
+    }
+
+    static ScratchCounters& local()
+    {
+        thread_local ThreadScratchCounters thread_counters;
+        return thread_counters.counters;
+    }
+
+    ScratchCounters counters;
+};
+
+/**
+ * @brief temporary vector of a scorer, borrowed from a per thread list of
+ * vectors that keep their memory between calls.
+ *
+ * The vector is empty when it is borrowed and is cleared when it is returned, so
+ * repeated calls of a scorer in batch mode only allocate when they need more memory
+ * than any call before them on the same thread. Nested scorers each borrow their
+ * own vector. Vectors above SCRATCH_MAX_BYTES are freed instead of kept.
+ */
+template <typename T>
+class ScratchVector {
+public:
+    static constexpr size_t SCRATCH_MAX_BYTES = size_t(1) << 20;
+
+    ScratchVector()
+    {
+        auto& free_list = free_vectors();
+        if (!free_list.empty()) {
+            m_vec = std::move(free_list.back());
+            free_list.pop_back();
+        }
+        m_capacity = m_vec.capacity();
+        ScratchCounters::add(ThreadScratchCounters::local().requests, 1);
+    }
+
+    ScratchVector(const ScratchVector&) = delete;
+    ScratchVector& operator=(const ScratchVector&) = delete;
+
+    ~ScratchVector()
+    {
+        if (m_vec.capacity() > m_capacity) {
+            auto& counters = ThreadScratchCounters::local();
+            ScratchCounters::add(counters.allocations, 1);
+            ScratchCounters::add(counters.bytes, (m_vec.capacity() - m_capacity) * sizeof(T));
+        }
+
+        if (m_vec.capacity() * sizeof(T) > SCRATCH_MAX_BYTES) return;
+        m_vec.clear();
+        free_vectors().push_back(std::move(m_vec));
+    }
+
+    std::vector<T>& operator*() noexcept
+    {
+        return m_vec;
+    }
+
+    std::vector<T>* operator->() noexcept
+    {
+        return &m_vec;
+    }
+
+private:
+    static std::vector<std::vector<T>>& free_vectors()
+    {
+        thread_local std::vector<std::vector<T>> free_list;
+        return free_list;
+    }
+
+    std::vector<T> m_vec;
+    size_t m_capacity;
+};
+
+} // namespace detail
+
+/**
+ * @brief scratch buffer counters summed over all threads
+ */
+static inline ScratchStats scratch_stats()
+{
+    return detail::ScratchRegistry::instance().stats();
+}
+
+static inline void reset_scratch_stats()
+{
+    detail::ScratchRegistry::instance().reset();
+}
+
+} // namespace rapidfuzz
@@ -35,6 +35,9 @@ public:
 
     std::vector<CharT> join() const;
 
+    /* joins the words into an existing buffer, e.g. a scratch buffer of the scorer */
+    void join(std::vector<CharT>& joined) const;
+
     const RangeVec<InputIt>& words() const
     {
         return m_sentence;
@@ -69,18 +72,25 @@ size_t SplittedSentenceView<InputIt>::size() const
 template <typename InputIt>
 auto SplittedSentenceView<InputIt>::join() const -> std::vector<CharT>
 {
-    if (m_sentence.empty()) {
-        return std::vector<CharT>();
-    }
+    std::vector<CharT> joined;
+    join(joined);
+    return joined;
+}
 
+template <typename InputIt>
+void SplittedSentenceView<InputIt>::join(std::vector<CharT>& joined) const
+{
+    joined.clear();
+    if (m_sentence.empty()) return;
+
+    joined.reserve(size());
     auto sentence_iter = m_sentence.begin();
-    std::vector<CharT> joined(sentence_iter->begin(), sentence_iter->end());
+    joined.insert(joined.end(), sentence_iter->begin(), sentence_iter->end());
     ++sentence_iter;
     for (; sentence_iter != m_sentence.end(); ++sentence_iter) {
         joined.push_back(0x20);
         joined.insert(joined.end(), sentence_iter->begin(), sentence_iter->end());
     }
-    return joined;
 }
 
 } // namespace rapidfuzz::detail
@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <stddef.h>
 #include <stdexcept>
+#include <stdint.h>
 #include <vector>
 
 namespace rapidfuzz {
@@ -566,6 +567,110 @@ inline Opcodes::Opcodes(const Editops& other)
     }
 }
 
+/**
+ * @brief Edit operations stored in 8 bytes each instead of the 24 bytes of EditOp
+ *
+ * Every operation is packed into a 64 bit word holding the type in the upper 2 bits,
+ * followed by the source and the destination position in 31 bits each. This limits the
+ * positions to max_pos, which is far above the length of strings edit operations are
+ * computed for, but allows keeping the edit operations of millions of string pairs in memory.
+ */
+class PackedEditops {
+public:
+    static constexpr size_t max_pos = (size_t(1) << 31) - 1;
+
+    PackedEditops() noexcept : src_len(0), dest_len(0)
+    {}
+
+    explicit PackedEditops(const Editops& other) : src_len(other.get_src_len()), dest_len(other.get_dest_len())
+    {
+        m_ops.reserve(other.size());
+        for (const auto& op : other)
+            push_back(op);
+    }
+
+    EditOp operator[](size_t pos) const
+    {
+        return EditOp(type(pos), src_pos(pos), dest_pos(pos));
+    }
+
+    EditType type(size_t pos) const
+    {
+        return static_cast<EditType>(m_ops[pos] >> 62);
+    }
+
+    size_t src_pos(size_t pos) const
+    {
+        return static_cast<size_t>((m_ops[pos] >> 31) & max_pos);
+    }
+
+    size_t dest_pos(size_t pos) const
+    {
+        return static_cast<size_t>(m_ops[pos] & max_pos);
+    }
+
+    size_t size() const noexcept
+    {
+        return m_ops.size();
+    }
+
+    bool empty() const noexcept
+    {
+        return m_ops.empty();
+    }
+
+    void reserve(size_t count)
+    {
+        m_ops.reserve(count);
+    }
+
+    void clear() noexcept
+    {
+        m_ops.clear();
+    }
+
+    void push_back(const EditOp& op)
+    {
+        if (op.src_pos > max_pos || op.dest_pos > max_pos)
+            throw std::length_error("edit operation position does not fit into PackedEditops");
+
+        m_ops.push_back((static_cast<uint64_t>(op.type) << 62) | (static_cast<uint64_t>(op.src_pos) << 31) |
+                        static_cast<uint64_t>(op.dest_pos));
+    }
+
+    Editops unpack() const
+    {
+        Editops ops(size());
+        ops.set_src_len(src_len);
+        ops.set_dest_len(dest_len);
+        for (size_t i = 0; i < size(); ++i)
+            ops[i] = (*this)[i];
+        return ops;
+    }
+
+    size_t get_src_len() const noexcept
+    {
+        return src_len;
+    }
+    void set_src_len(size_t len) noexcept
+    {
+        src_len = len;
+    }
+    size_t get_dest_len() const noexcept
+    {
+        return dest_len;
+    }
+    void set_dest_len(size_t len) noexcept
+    {
+        dest_len = len;
+    }
+
+private:
+    std::vector<uint64_t> m_ops;
+    size_t src_len;
+    size_t dest_len;
+};
+
 template <typename T>
 struct ScoreAlignment {
     T score;           /**< resulting score of the algorithm */
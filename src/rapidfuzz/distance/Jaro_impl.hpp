@@ -135,10 +135,11 @@ static inline void flag_similar_characters_step(const BlockPatternMatchVector& P
     size_t j_pos = j % 64;
     size_t word = BoundMask.empty_words;
     size_t last_word = word + BoundMask.words;
+    auto PM_row = PM.row(T_j);
 
     if (BoundMask.words == 1) {
         uint64_t PM_j =
-            PM.get(word, T_j) & BoundMask.last_mask & BoundMask.first_mask & (~flagged.P_flag[word]);
+            PM_row[word] & BoundMask.last_mask & BoundMask.first_mask & (~flagged.P_flag[word]);
 
         flagged.P_flag[word] |= blsi(PM_j);
         flagged.T_flag[j_word] |= static_cast<uint64_t>(PM_j != 0) << j_pos;
@@ -146,7 +147,7 @@ static inline void flag_similar_characters_step(const BlockPatternMatchVector& P
     }
 
     if (BoundMask.first_mask) {
-        uint64_t PM_j = PM.get(word, T_j) & BoundMask.first_mask & (~flagged.P_flag[word]);
+        uint64_t PM_j = PM_row[word] & BoundMask.first_mask & (~flagged.P_flag[word]);
 
         if (PM_j) {
             flagged.P_flag[word] |= blsi(PM_j);
@@ -161,7 +162,7 @@ static inline void flag_similar_characters_step(const BlockPatternMatchVector& P
         for (; word + 3 < last_word - 1; word += 4) {
             uint64_t PM_j[4];
             unroll<int, 4>([&](auto i) {
-                PM_j[i] = PM.get(word + i, static_cast<uint8_t>(T_j)) & (~flagged.P_flag[word + i]);
+                PM_j[i] = PM_row[word + i] & (~flagged.P_flag[word + i]);
             });
 
             if (PM_j[0]) {
@@ -188,7 +189,7 @@ static inline void flag_similar_characters_step(const BlockPatternMatchVector& P
     }
 
     for (; word < last_word - 1; ++word) {
-        uint64_t PM_j = PM.get(word, T_j) & (~flagged.P_flag[word]);
+        uint64_t PM_j = PM_row[word] & (~flagged.P_flag[word]);
 
         if (PM_j) {
             flagged.P_flag[word] |= blsi(PM_j);
@@ -198,7 +199,7 @@ static inline void flag_similar_characters_step(const BlockPatternMatchVector& P
     }
 
     if (BoundMask.last_mask) {
-        uint64_t PM_j = PM.get(word, T_j) & BoundMask.last_mask & (~flagged.P_flag[word]);
+        uint64_t PM_j = PM_row[word] & BoundMask.last_mask & (~flagged.P_flag[word]);
 
         flagged.P_flag[word] |= blsi(PM_j);
         flagged.T_flag[j_word] |= static_cast<uint64_t>(PM_j != 0) << j_pos;
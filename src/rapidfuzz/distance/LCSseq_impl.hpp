@@ -187,6 +187,106 @@ void lcs_simd(Range<size_t*> scores, const BlockPatternMatchVector& block, const
 
 #endif
 
+template <typename VecType, typename PMV, typename InputIt>
+void lcs_windows_impl(Range<size_t*> scores, const PMV& PM, const Range<InputIt>& s2, size_t window_len)
+{
+    /* window i reads the characters s2[i, i + window_len), so the match vectors
+     * of consecutive windows in step j are the consecutive entries M[i + j] */
+    std::vector<VecType> M(s2.size());
+    auto iter_s2 = s2.begin();
+    for (auto& matches : M) {
+        matches = static_cast<VecType>(PM.get(0, *iter_s2));
+        ++iter_s2;
+    }
+
+    auto score_iter = scores.begin();
+    size_t window_count = scores.size();
+    size_t start = 0;
+
+#ifdef RAPIDFUZZ_SIMD
+#    ifdef RAPIDFUZZ_AVX2
+    using namespace simd_avx2;
+    auto load = [](const VecType* p) {
+        return native_simd<VecType>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+    };
+#    else
+    using namespace simd_sse2;
+    auto load = [](const VecType* p) {
+        return native_simd<VecType>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+    };
+#    endif
+    static constexpr size_t vecs = static_cast<size_t>(native_simd<VecType>::size);
+    static constexpr size_t interleaveCount = 3;
+
+    for (; start + interleaveCount * vecs <= window_count; start += interleaveCount * vecs) {
+        std::array<native_simd<VecType>, interleaveCount> S;
+        unroll<int, interleaveCount>([&](auto j) { S[j] = static_cast<VecType>(-1); });
+
+        const VecType* matches = M.data() + start;
+        for (size_t i = 0; i < window_len; ++i, ++matches) {
+            unroll<int, interleaveCount>([&](auto j) {
+                native_simd<VecType> Matches = load(matches + j * vecs);
+                native_simd<VecType> u = S[j] & Matches;
+                S[j] = (S[j] + u) | (S[j] - u);
+            });
+        }
+
+        unroll<int, interleaveCount>([&](auto j) {
+            auto counts = popcount(~S[j]);
+            unroll<int, counts.size()>([&](auto k) {
+                *score_iter = static_cast<size_t>(counts[k]);
+                score_iter++;
+            });
+        });
+    }
+#endif
+
+    static constexpr size_t scalar_lanes = 4;
+    for (; start < window_count; start += scalar_lanes) {
+        size_t count = std::min(scalar_lanes, window_count - start);
+        VecType S[scalar_lanes];
+        unroll<size_t, scalar_lanes>([&](size_t j) { S[j] = static_cast<VecType>(-1); });
+
+        const VecType* matches = M.data() + start;
+        for (size_t i = 0; i < window_len; ++i, ++matches) {
+            unroll<size_t, scalar_lanes>([&](size_t j) {
+                if (j >= count) return;
+                VecType u = S[j] & matches[j];
+                S[j] = static_cast<VecType>((S[j] + u) | (S[j] - u));
+            });
+        }
+
+        for (size_t j = 0; j < count; ++j) {
+            *score_iter = static_cast<size_t>(popcount(static_cast<uint64_t>(static_cast<VecType>(~S[j]))));
+            score_iter++;
+        }
+    }
+}
+
+/**
+ * @brief LCS between a pattern with up to 64 characters and every window
+ * s2[i, i + window_len) for i in [0, scores.size())
+ *
+ * The windows are independent alignments against the same pattern, so they
+ * are calculated side by side in one sweep over s2. Since consecutive windows
+ * are shifted by one character, the matches of a group of windows are a
+ * contiguous slice of the matches of s2, which fills one vector with a single
+ * load. The lanes are chosen as narrow as the pattern allows, so patterns with
+ * up to 8 characters are aligned with 32 windows at once when AVX2 is available.
+ */
+template <typename PMV, typename InputIt>
+void lcs_windows(Range<size_t*> scores, const PMV& PM, const Range<InputIt>& s2, size_t window_len)
+{
+    if (window_len <= 8)
+        lcs_windows_impl<uint8_t>(scores, PM, s2, window_len);
+    else if (window_len <= 16)
+        lcs_windows_impl<uint16_t>(scores, PM, s2, window_len);
+    else if (window_len <= 32)
+        lcs_windows_impl<uint32_t>(scores, PM, s2, window_len);
+    else
+        lcs_windows_impl<uint64_t>(scores, PM, s2, window_len);
+}
+
 template <size_t N, bool RecordMatrix, typename PMV, typename InputIt1, typename InputIt2>
 auto lcs_unroll(const PMV& block, const Range<InputIt1>&, const Range<InputIt2>& s2,
                 size_t score_cutoff = 0) -> LCSseqResult<RecordMatrix>
@@ -272,8 +372,9 @@ auto lcs_blockwise(const PMV& PM, const Range<InputIt1>& s1, const Range<InputIt
 
         if constexpr (RecordMatrix) res.S.set_offset(row, static_cast<ptrdiff_t>(first_block * word_size));
 
+        auto PM_row = PM.row(*iter_s2);
         for (size_t word = first_block; word < last_block; ++word) {
-            const uint64_t Matches = PM.get(word, *iter_s2);
+            const uint64_t Matches = PM_row[word];
             uint64_t Stemp = S[word];
 
             uint64_t u = Stemp & Matches;
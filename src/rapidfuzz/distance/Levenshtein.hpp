@@ -489,4 +489,362 @@ template <typename InputIt1>
 CachedLevenshtein(InputIt1 first1, InputIt1 last1,
                   LevenshteinWeightTable aWeights = {1, 1, 1}) -> CachedLevenshtein<iter_value_t<InputIt1>>;
 
+namespace experimental {
+/**
+ * @brief streaming approximate substring search, that reports every position of a text
+ * where a substring ending there has a Levenshtein distance <= max to the pattern.
+ * The text can be passed in chunks of any size and the memory usage only depends
+ * on the length of the pattern and max, so it is usable on arbitrarily large texts.
+ *
+ * @code{.cpp}
+ * LevenshteinSearch<char> search("needle", 1);
+ * search.feed(chunk.begin(), chunk.end(), [&](size_t end, size_t dist) {
+ *     size_t start = search.match_start(end, dist);
+ * });
+ * @endcode
+ */
+template <typename CharT1>
+struct LevenshteinSearch {
+    template <typename Sentence1>
+    LevenshteinSearch(const Sentence1& s1_, size_t max)
+        : LevenshteinSearch(detail::to_begin(s1_), detail::to_end(s1_), max)
+    {}
+
+    template <typename InputIt1>
+    LevenshteinSearch(InputIt1 first1, InputIt1 last1, size_t max)
+        : len1(static_cast<size_t>(std::distance(first1, last1))),
+          max_dist(std::min(max, len1)),
+          PM(detail::Range(first1, last1)),
+          PM_rev(detail::Range(first1, last1).reversed())
+    {
+        if (len1 == 0) throw std::invalid_argument("pattern must not be empty");
+
+        /* the history has to hold the longest possible match behind every character of a chunk */
+        size_t max_match = len1 + max_dist;
+        size_t history_size = 1;
+        while (history_size < 2 * max_match)
+            history_size <<= 1;
+
+        history.resize(history_size);
+        chunk_size = history_size - max_match;
+        reset();
+    }
+
+    /**
+     * @brief restarts the search at the beginning of a new text
+     */
+    void reset()
+    {
+        detail::levenshtein_search_init(PM, len1, max_dist, state);
+        pos = 0;
+    }
+
+    /**
+     * @brief number of characters searched since the last reset
+     */
+    size_t position() const noexcept
+    {
+        return pos;
+    }
+
+    /**
+     * @brief continues the search with the next chunk of the text
+     *
+     * @param callback called as callback(end, dist) for every match, where end is the
+     * number of characters read up to and including the last character of the match
+     */
+    template <typename Sentence2, typename Callback>
+    void feed(const Sentence2& s2, Callback&& callback)
+    {
+        feed(detail::to_begin(s2), detail::to_end(s2), std::forward<Callback>(callback));
+    }
+
+    template <typename InputIt2, typename Callback>
+    void feed(InputIt2 first2, InputIt2 last2, Callback&& callback)
+    {
+        size_t history_mask = history.size() - 1;
+        while (first2 != last2) {
+            auto chunk_end = first2;
+            size_t len = 0;
+            for (; chunk_end != last2 && len < chunk_size; ++chunk_end, ++len)
+                history[(pos + len) & history_mask] = to_key(*chunk_end);
+
+            size_t chunk_pos = pos;
+            pos += len;
+            detail::levenshtein_search(PM, len1, detail::Range(first2, chunk_end), max_dist, state,
+                                       [&](size_t i, size_t dist) { callback(chunk_pos + i + 1, dist); });
+            first2 = chunk_end;
+        }
+    }
+
+    /**
+     * @brief finds the start of the longest substring ending at end with a distance of dist
+     * to the pattern. This can only be called from the callback of feed, since the
+     * text is only stored until the longest possible match can not change anymore
+     */
+    size_t match_start(size_t end, size_t dist)
+    {
+        size_t history_mask = history.size() - 1;
+        size_t len = std::min(end, len1 + dist);
+        window.resize(len);
+        for (size_t i = 0; i < len; ++i)
+            window[i] = history[(end - 1 - i) & history_mask];
+
+        return end - detail::levenshtein_search_start(PM_rev, len1, detail::Range(window), dist);
+    }
+
+private:
+    static uint64_t to_key(char ch) noexcept
+    {
+        return static_cast<uint8_t>(ch);
+    }
+
+    template <typename CharT>
+    static uint64_t to_key(CharT ch) noexcept
+    {
+        return static_cast<uint64_t>(ch);
+    }
+
+    size_t len1;
+    size_t max_dist;
+    detail::BlockPatternMatchVector PM;
+    detail::BlockPatternMatchVector PM_rev;
+    detail::LevenshteinSearchState state;
+    std::vector<uint64_t> history;
+    std::vector<uint64_t> window;
+    size_t chunk_size;
+    size_t pos = 0;
+};
+
+template <typename Sentence1>
+LevenshteinSearch(const Sentence1& s1_, size_t max) -> LevenshteinSearch<char_type<Sentence1>>;
+
+template <typename InputIt1>
+LevenshteinSearch(InputIt1 first1, InputIt1 last1, size_t max) -> LevenshteinSearch<iter_value_t<InputIt1>>;
+/**
+ * @brief Levenshtein distance between a set of choices and a query that is typed one character at a time.
+ * The last column of the matrix between every choice and the query is kept, so appending a character
+ * only requires a single step of Hyyrö's algorithm per choice. Choices are dropped once every cell of
+ * the column exceeds score_cutoff, since the distance can not get below it for any longer query.
+ * Every append stores the previous state, so characters can be removed again with pop_back.
+ */
+template <typename CharT1>
+struct IncrementalLevenshtein {
+    template <typename InputIt>
+    IncrementalLevenshtein(InputIt first, InputIt last, size_t score_cutoff)
+        : m_score_cutoff(score_cutoff), m_PM(count_blocks(first, last))
+    {
+        size_t block = 0;
+        for (; first != last; ++first) {
+            auto s1 = detail::Range(*first);
+            m_block_offsets.push_back(block);
+            m_lens.push_back(s1.size());
+
+            size_t i = 0;
+            for (auto iter = s1.begin(); iter != s1.end(); ++iter, ++i)
+                m_PM.insert(block + i / 64, *iter, static_cast<int>(i % 64));
+            block += detail::ceil_div(s1.size(), 64);
+        }
+        m_block_offsets.push_back(block);
+        clear();
+    }
+
+    /**
+     * @brief removes all characters from the query
+     */
+    void clear()
+    {
+        m_history.clear();
+        m_state.active.resize(m_lens.size());
+        m_state.dist = m_lens;
+        m_state.vecs.assign(m_block_offsets.back(), detail::LevenshteinRow());
+        for (size_t i = 0; i < m_lens.size(); ++i)
+            m_state.active[i] = i;
+    }
+
+    /**
+     * @brief length of the query
+     */
+    size_t size() const noexcept
+    {
+        return m_history.size();
+    }
+
+    /**
+     * @brief number of choices, which can still be within score_cutoff
+     */
+    size_t active_count() const noexcept
+    {
+        return m_state.active.size();
+    }
+
+    /**
+     * @brief appends a character to the query
+     */
+    template <typename CharT2>
+    void push_back(CharT2 ch)
+    {
+        m_history.push_back(m_state);
+
+        auto& active = m_state.active;
+        auto& dists = m_state.dist;
+        auto& vecs = m_state.vecs;
+        size_t vec_pos = 0;
+        for (size_t k = 0; k < active.size(); ++k) {
+            size_t i = active[k];
+            size_t words = m_block_offsets[i + 1] - m_block_offsets[i];
+            dists[k] = step(&vecs[vec_pos], m_block_offsets[i], words, m_lens[i], dists[k], ch);
+            vec_pos += words;
+        }
+
+        prune(size());
+    }
+
+    /**
+     * @brief removes the last character of the query
+     */
+    void pop_back()
+    {
+        if (m_history.empty()) throw std::out_of_range("query is empty");
+
+        m_state = std::move(m_history.back());
+        m_history.pop_back();
+    }
+
+    /**
+     * @brief calls func(index, dist) for every choice with a distance <= score_cutoff to the query
+     */
+    template <typename Func>
+    void for_each_match(Func&& func) const
+    {
+        for (size_t k = 0; k < m_state.active.size(); ++k)
+            if (m_state.dist[k] <= m_score_cutoff) func(m_state.active[k], m_state.dist[k]);
+    }
+
+private:
+    struct State {
+        std::vector<size_t> active;
+        std::vector<size_t> dist;
+        std::vector<detail::LevenshteinRow> vecs;
+    };
+
+    template <typename InputIt>
+    static size_t count_blocks(InputIt first, InputIt last)
+    {
+        size_t blocks = 0;
+        for (; first != last; ++first)
+            blocks += detail::ceil_div(detail::Range(*first).size(), 64);
+
+        /* BlockPatternMatchVector can not be empty */
+        return std::max<size_t>(blocks, 1) * 64;
+    }
+
+    template <typename CharT2>
+    size_t step(detail::LevenshteinRow* vecs, size_t first_block, size_t words, size_t len1, size_t dist,
+                CharT2 ch) const
+    {
+        if (words == 0) return dist + 1;
+
+        uint64_t HP_carry = 1;
+        uint64_t HN_carry = 0;
+        uint64_t Last = UINT64_C(1) << ((len1 - 1) % 64);
+        for (size_t word = 0; word < words; ++word) {
+            uint64_t X = m_PM.get(first_block + word, ch) | HN_carry;
+            uint64_t VP = vecs[word].VP;
+            uint64_t VN = vecs[word].VN;
+            uint64_t D0 = (((X & VP) + VP) ^ VP) | X | VN;
+
+            uint64_t HP = VN | ~(D0 | VP);
+            uint64_t HN = D0 & VP;
+
+            uint64_t HP_carry_temp = HP_carry;
+            uint64_t HN_carry_temp = HN_carry;
+            if (word < words - 1) {
+                HP_carry = HP >> 63;
+                HN_carry = HN >> 63;
+            }
+            else {
+                HP_carry = bool(HP & Last);
+                HN_carry = bool(HN & Last);
+            }
+
+            HP = (HP << 1) | HP_carry_temp;
+            HN = (HN << 1) | HN_carry_temp;
+
+            vecs[word].VP = HN | ~(D0 | HP);
+            vecs[word].VN = HP & D0;
+        }
+
+        return dist + HP_carry - HN_carry;
+    }
+
+    /**
+     * @brief checks whether any cell of the column is <= score_cutoff.
+     * The column starts with the query length and only decreases at the bits set in VN,
+     * so only the cells at these bits have to be checked
+     */
+    bool column_in_cutoff(const detail::LevenshteinRow* vecs, size_t words, size_t len1, size_t len2) const
+    {
+        size_t score = len2;
+        if (score <= m_score_cutoff) return true;
+
+        for (size_t word = 0; word < words; ++word) {
+            uint64_t mask = ~UINT64_C(0);
+            if (word + 1 == words && len1 % 64) mask >>= 64 - len1 % 64;
+
+            uint64_t VP = vecs[word].VP & mask;
+            uint64_t VN = vecs[word].VN & mask;
+            for (uint64_t bits = VN; bits; bits = detail::blsr(bits)) {
+                uint64_t prefix = detail::blsmsk(bits);
+                if (score + detail::popcount(VP & prefix) - detail::popcount(VN & prefix) <= m_score_cutoff)
+                    return true;
+            }
+
+            score = score + detail::popcount(VP) - detail::popcount(VN);
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief removes the choices that can not get within score_cutoff for any longer query
+     */
+    void prune(size_t len2)
+    {
+        auto& active = m_state.active;
+        auto& dists = m_state.dist;
+        auto& vecs = m_state.vecs;
+        size_t out = 0;
+        size_t vec_in = 0;
+        size_t vec_out = 0;
+        for (size_t k = 0; k < active.size(); ++k) {
+            size_t i = active[k];
+            size_t words = m_block_offsets[i + 1] - m_block_offsets[i];
+            if (dists[k] <= m_score_cutoff || column_in_cutoff(&vecs[vec_in], words, m_lens[i], len2)) {
+                std::copy(vecs.begin() + static_cast<ptrdiff_t>(vec_in),
+                          vecs.begin() + static_cast<ptrdiff_t>(vec_in + words),
+                          vecs.begin() + static_cast<ptrdiff_t>(vec_out));
+                active[out] = i;
+                dists[out] = dists[k];
+                out++;
+                vec_out += words;
+            }
+            vec_in += words;
+        }
+
+        active.resize(out);
+        dists.resize(out);
+        vecs.resize(vec_out);
+    }
+
+    size_t m_score_cutoff;
+    detail::BlockPatternMatchVector m_PM;
+    std::vector<size_t> m_block_offsets;
+    std::vector<size_t> m_lens;
+    State m_state;
+    std::vector<State> m_history;
+};
+
+} /* namespace experimental */
+
 } // namespace rapidfuzz
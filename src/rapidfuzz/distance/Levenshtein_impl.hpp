@@ -7,6 +7,7 @@
 #include <rapidfuzz/details/GrowingHashmap.hpp>
 #include <rapidfuzz/details/Matrix.hpp>
 #include <rapidfuzz/details/PatternMatchVector.hpp>
+#include <rapidfuzz/details/Scratch.hpp>
 #include <rapidfuzz/details/common.hpp>
 #include <rapidfuzz/details/distance.hpp>
 #include <rapidfuzz/details/intrinsics.hpp>
@@ -615,8 +616,12 @@ auto levenshtein_hyrroe2003_block(const BlockPatternMatchVector& PM, const Range
 
     size_t word_size = sizeof(uint64_t) * 8;
     size_t words = PM.size();
-    std::vector<LevenshteinRow> vecs(words);
-    std::vector<size_t> scores(words);
+    ScratchVector<LevenshteinRow> vecs_buffer;
+    ScratchVector<size_t> scores_buffer;
+    auto& vecs = *vecs_buffer;
+    auto& scores = *scores_buffer;
+    vecs.assign(words, LevenshteinRow());
+    scores.assign(words, 0);
     uint64_t Last = UINT64_C(1) << ((s1.size() - 1) % word_size);
 
     for (size_t i = 0; i < words - 1; ++i)
@@ -656,9 +661,11 @@ auto levenshtein_hyrroe2003_block(const BlockPatternMatchVector& PM, const Range
             res.VN.set_offset(row, static_cast<ptrdiff_t>(first_block * word_size));
         }
 
+        auto PM_row = PM.row(*iter_s2);
+
         auto advance_block = [&](size_t word) {
             /* Step 1: Computing D0 */
-            uint64_t PM_j = PM.get(word, *iter_s2);
+            uint64_t PM_j = PM_row[word];
             uint64_t VN = vecs[word].VN;
             uint64_t VP = vecs[word].VP;
 
@@ -791,7 +798,8 @@ auto levenshtein_hyrroe2003_block(const BlockPatternMatchVector& PM, const Range
 
                 res.first_block = first_block;
                 res.last_block = last_block;
-                res.vecs = std::move(vecs);
+                /* copied, since the scratch buffer is reused by the next call */
+                res.vecs.assign(vecs.begin(), vecs.end());
 
                 /* unknown so make sure it is <= max */
                 res.dist = 0;
@@ -807,6 +815,205 @@ auto levenshtein_hyrroe2003_block(const BlockPatternMatchVector& PM, const Range
     return res;
 }
 
+/**
+ * @brief state of the approximate substring search of a pattern s1 in a text,
+ * which is the last column of the Levenshtein matrix between s1 and the text read so far
+ *
+ * scores[word] stores the value of the last row of the block, while only the blocks
+ * up to last_block can contain cells <= max. All blocks behind it are recalculated
+ * from scratch once the band reaches them again (Myers 1999, Hyyrö 2003)
+ */
+struct LevenshteinSearchState {
+    std::vector<LevenshteinRow> vecs;
+    std::vector<size_t> scores;
+    size_t last_block = 0;
+};
+
+template <typename PM_Vec>
+void levenshtein_search_init(const PM_Vec& PM, size_t len1, size_t max, LevenshteinSearchState& state)
+{
+    size_t words = PM.size();
+    state.vecs.assign(words, LevenshteinRow());
+    state.scores.resize(words);
+    for (size_t word = 0; word < words; ++word)
+        state.scores[word] = std::min((word + 1) * 64, len1);
+
+    /* the first column is 0, 1, 2 ... so only blocks starting at rows <= max can contain a match */
+    state.last_block = std::min(words, ceil_div(max + 1, 64)) - 1;
+}
+
+/**
+ * @brief searches all substrings of s2 with a Levenshtein distance <= max to s1.
+ * In difference to levenshtein_hyrroe2003 the first row of the matrix is 0, so a match
+ * can start at any position of s2. The state is kept between calls, so s2 can be passed in chunks.
+ *
+ * @param callback called as callback(i, dist) for every position i of s2 where a
+ * substring ending with s2[i] has a distance dist <= max to s1
+ */
+template <typename PM_Vec, typename InputIt2, typename Callback>
+void levenshtein_search(const PM_Vec& PM, size_t len1, const Range<InputIt2>& s2, size_t max,
+                        LevenshteinSearchState& state, Callback&& callback)
+{
+    assert(len1 != 0);
+    size_t words = PM.size();
+    auto& vecs = state.vecs;
+    auto& scores = state.scores;
+
+    if (words == 1) {
+        uint64_t VP = vecs[0].VP;
+        uint64_t VN = vecs[0].VN;
+        size_t dist = scores[0];
+        uint64_t mask = UINT64_C(1) << (len1 - 1);
+
+        auto iter_s2 = s2.begin();
+        for (size_t i = 0; iter_s2 != s2.end(); ++iter_s2, ++i) {
+            uint64_t X = PM.get(0, *iter_s2);
+            uint64_t D0 = (((X & VP) + VP) ^ VP) | X | VN;
+            uint64_t HP = VN | ~(D0 | VP);
+            uint64_t HN = D0 & VP;
+
+            dist += bool(HP & mask);
+            dist -= bool(HN & mask);
+
+            /* the first row is 0 in every column, so no horizontal delta is shifted in */
+            HP <<= 1;
+            HN <<= 1;
+
+            VP = HN | ~(D0 | HP);
+            VN = HP & D0;
+
+            if (dist <= max) callback(i, dist);
+        }
+
+        vecs[0] = LevenshteinRow(VP, VN);
+        scores[0] = dist;
+        return;
+    }
+
+    uint64_t Last = UINT64_C(1) << ((len1 - 1) % 64);
+    size_t last_block = state.last_block;
+
+    auto iter_s2 = s2.begin();
+    for (size_t i = 0; iter_s2 != s2.end(); ++iter_s2, ++i) {
+        uint64_t HP_carry = 0;
+        uint64_t HN_carry = 0;
+
+        auto PM_row = PM.row(*iter_s2);
+
+        auto advance_block = [&](size_t word) {
+            uint64_t PM_j = PM_row[word];
+            uint64_t VN = vecs[word].VN;
+            uint64_t VP = vecs[word].VP;
+
+            uint64_t X = PM_j | HN_carry;
+            uint64_t D0 = (((X & VP) + VP) ^ VP) | X | VN;
+
+            uint64_t HP = VN | ~(D0 | VP);
+            uint64_t HN = D0 & VP;
+
+            uint64_t HP_carry_temp = HP_carry;
+            uint64_t HN_carry_temp = HN_carry;
+            if (word < words - 1) {
+                HP_carry = HP >> 63;
+                HN_carry = HN >> 63;
+            }
+            else {
+                HP_carry = bool(HP & Last);
+                HN_carry = bool(HN & Last);
+            }
+
+            HP = (HP << 1) | HP_carry_temp;
+            HN = (HN << 1) | HN_carry_temp;
+
+            vecs[word].VP = HN | ~(D0 | HP);
+            vecs[word].VN = HP & D0;
+
+            scores[word] = scores[word] + HP_carry - HN_carry;
+        };
+
+        for (size_t word = 0; word <= last_block; word++)
+            advance_block(word);
+
+        /* the first row of the next block is at least the last row of this block in the previous column */
+        size_t prev_score = scores[last_block] - HP_carry + HN_carry;
+        if (last_block + 1 < words && prev_score <= max) {
+            last_block++;
+            vecs[last_block] = LevenshteinRow();
+            scores[last_block] = prev_score + std::min(64 * (last_block + 1), len1) - 64 * last_block;
+            advance_block(last_block);
+        }
+        else {
+            /* all cells of a block are > max when the last row is >= max + rows in the block */
+            while (last_block > 0 &&
+                   scores[last_block] >= max + std::min(64 * (last_block + 1), len1) - 64 * last_block)
+                last_block--;
+        }
+
+        if (last_block + 1 == words && scores[last_block] <= max) callback(i, scores[last_block]);
+    }
+
+    state.last_block = last_block;
+}
+
+/**
+ * @brief finds the start of the match found by levenshtein_search that ends at the last character
+ * of s2. s2 has to be passed in reverse order together with the pattern match vector of the reversed
+ * pattern and has to hold at least len1 + dist characters (or all characters read so far)
+ *
+ * @return length of the longest substring ending at the match end with a distance of dist
+ */
+template <typename PM_Vec, typename InputIt2>
+size_t levenshtein_search_start(const PM_Vec& PM_rev, size_t len1, const Range<InputIt2>& s2_rev, size_t dist)
+{
+    size_t words = PM_rev.size();
+    ScratchVector<LevenshteinRow> vecs_buffer;
+    auto& vecs = *vecs_buffer;
+    vecs.assign(words, LevenshteinRow());
+    uint64_t Last = UINT64_C(1) << ((len1 - 1) % 64);
+    size_t score = len1;
+    size_t match_len = 0;
+
+    auto iter_s2 = s2_rev.begin();
+    for (size_t j = 1; iter_s2 != s2_rev.end() && j <= len1 + dist; ++iter_s2, ++j) {
+        uint64_t HP_carry = 1;
+        uint64_t HN_carry = 0;
+
+        for (size_t word = 0; word < words; ++word) {
+            uint64_t PM_j = PM_rev.get(word, *iter_s2);
+            uint64_t VN = vecs[word].VN;
+            uint64_t VP = vecs[word].VP;
+
+            uint64_t X = PM_j | HN_carry;
+            uint64_t D0 = (((X & VP) + VP) ^ VP) | X | VN;
+
+            uint64_t HP = VN | ~(D0 | VP);
+            uint64_t HN = D0 & VP;
+
+            uint64_t HP_carry_temp = HP_carry;
+            uint64_t HN_carry_temp = HN_carry;
+            if (word < words - 1) {
+                HP_carry = HP >> 63;
+                HN_carry = HN >> 63;
+            }
+            else {
+                HP_carry = bool(HP & Last);
+                HN_carry = bool(HN & Last);
+            }
+
+            HP = (HP << 1) | HP_carry_temp;
+            HN = (HN << 1) | HN_carry_temp;
+
+            vecs[word].VP = HN | ~(D0 | HP);
+            vecs[word].VN = HP & D0;
+        }
+
+        score = score + HP_carry - HN_carry;
+        if (score == dist) match_len = j;
+    }
+
+    return match_len;
+}
+
 template <typename InputIt1, typename InputIt2>
 size_t uniform_levenshtein_distance(const BlockPatternMatchVector& block, Range<InputIt1> s1,
                                     Range<InputIt2> s2, size_t score_cutoff, size_t score_hint)
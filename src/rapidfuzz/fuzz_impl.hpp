@@ -3,7 +3,9 @@
 /* Copyright © 2011 Adam Cohen */
 
 #include <limits>
+#include <rapidfuzz/details/CharHistogram.hpp>
 #include <rapidfuzz/details/CharSet.hpp>
+#include <rapidfuzz/details/Scratch.hpp>
 
 #include <algorithm>
 #include <cmath>
@@ -63,6 +65,68 @@ static inline size_t score_cutoff_to_distance(double score_cutoff, size_t lensum
     return static_cast<size_t>(std::ceil(static_cast<double>(lensum) * (1.0 - score_cutoff / 100)));
 }
 
+/**
+ * @brief upper bound for ratio based on the lengths and the L1 difference
+ * of the character histograms
+ */
+static inline double ratio_upper_bound(size_t len1, size_t len2, size_t hist_diff = 0)
+{
+    size_t lensum = len1 + len2;
+    size_t dist = detail::indel_lower_bound(len1, len2, hist_diff);
+    double norm_dist = (lensum != 0) ? static_cast<double>(dist) / static_cast<double>(lensum) : 0.0;
+    return (1.0 - norm_dist) * 100;
+}
+
+/**
+ * @brief upper bound for WRatio. Only the ratio can be bounded, while the
+ * partial and token based ratios are limited by the scale they are weighted with
+ */
+static inline double WRatio_upper_bound(size_t len1, size_t len2, size_t hist_diff = 0)
+{
+    constexpr double UNBASE_SCALE = 0.95;
+
+    if (!len1 || !len2) return 0;
+
+    double len_ratio = (len1 > len2) ? static_cast<double>(len1) / static_cast<double>(len2)
+                                     : static_cast<double>(len2) / static_cast<double>(len1);
+
+    double ratio_bound = ratio_upper_bound(len1, len2, hist_diff);
+    if (len_ratio < 1.5) return std::max(ratio_bound, 100 * UNBASE_SCALE);
+
+    const double PARTIAL_SCALE = (len_ratio < 8.0) ? 0.9 : 0.6;
+    return std::max(ratio_bound, 100 * PARTIAL_SCALE);
+}
+
+/**
+ * @brief needles up to this length have all their windows calculated in one
+ * sweep once there are at least PARTIAL_RATIO_SWEEP_MIN_WINDOWS windows. Longer
+ * needles only fit into 64 bit lanes, where bisecting the windows is faster
+ */
+static constexpr size_t PARTIAL_RATIO_SWEEP_MAX_LEN = 32;
+static constexpr size_t PARTIAL_RATIO_SWEEP_MIN_WINDOWS = 16;
+
+/**
+ * @brief depth at which bisecting the windows [0, last] visits window pos. Both ends
+ * have depth 0 and the center of a range is one level deeper than the range. Windows
+ * of one depth are visited from left to right.
+ */
+static inline size_t bisection_depth(size_t pos, size_t last)
+{
+    if (pos == 0 || pos == last) return 0;
+
+    size_t first = 0;
+    size_t depth = 1;
+    while (true) {
+        size_t center = first + (last - first) / 2;
+        if (pos == center) return depth;
+        if (pos < center)
+            last = center;
+        else
+            first = center;
+        ++depth;
+    }
+}
+
 template <typename InputIt1, typename InputIt2, typename CachedCharT1>
 ScoreAlignment<double>
 partial_ratio_impl(const detail::Range<InputIt1>& s1, const detail::Range<InputIt2>& s2,
@@ -82,9 +146,45 @@ partial_ratio_impl(const detail::Range<InputIt1>& s1, const detail::Range<InputI
         double norm_cutoff_sim = rapidfuzz::detail::NormSim_to_NormDist(score_cutoff / 100);
         size_t cutoff_dist = static_cast<size_t>(std::ceil(static_cast<double>(maximum) * norm_cutoff_sim));
         size_t best_dist = std::numeric_limits<size_t>::max();
-        std::vector<size_t> scores(len2 - len1, std::numeric_limits<size_t>::max());
-        std::vector<std::pair<size_t, size_t>> windows = {{0, len2 - len1 - 1}};
-        std::vector<std::pair<size_t, size_t>> new_windows;
+        detail::ScratchVector<size_t> scores_buffer;
+        detail::ScratchVector<std::pair<size_t, size_t>> windows_buffer;
+        detail::ScratchVector<std::pair<size_t, size_t>> new_windows_buffer;
+        auto& scores = *scores_buffer;
+        auto& windows = *windows_buffer;
+        auto& new_windows = *new_windows_buffer;
+        scores.assign(len2 - len1, std::numeric_limits<size_t>::max());
+        windows.emplace_back(0, len2 - len1 - 1);
+
+#ifdef RAPIDFUZZ_SIMD
+        /* for short needles the LCS of all windows is calculated in a single sweep over s2,
+         * which is cheaper than bisecting the windows once there are enough of them */
+        if (len1 <= PARTIAL_RATIO_SWEEP_MAX_LEN && len2 - len1 >= PARTIAL_RATIO_SWEEP_MIN_WINDOWS) {
+            windows.clear();
+            detail::PatternMatchVector PM(s1);
+            detail::lcs_windows(detail::Range(scores.data(), scores.data() + scores.size()), PM, s2, len1);
+
+            /* of the windows with the smallest distance, the one the bisection visits first is
+             * selected, so the alignment does not depend on whether the sweep is used */
+            size_t best_depth = 0;
+            for (size_t i = 0; i < scores.size(); ++i) {
+                size_t dist = maximum - 2 * scores[i];
+                if (dist > cutoff_dist || (dist == cutoff_dist && dist != best_dist)) continue;
+
+                size_t depth = bisection_depth(i, scores.size() - 1);
+                if (dist < cutoff_dist || depth < best_depth) {
+                    cutoff_dist = best_dist = dist;
+                    best_depth = depth;
+                    res.dest_start = i;
+                    res.dest_end = i + len1;
+                }
+            }
+
+            if (best_dist == 0) {
+                res.score = 100;
+                return res;
+            }
+        }
+#endif
 
         while (!windows.empty()) {
             for (const auto& window : windows) {
@@ -385,8 +485,12 @@ double token_set_ratio(const rapidfuzz::detail::SplittedSentenceView<InputIt1>&
     // one sentence is part of the other one
     if (!intersect.empty() && (diff_ab.empty() || diff_ba.empty())) return 100;
 
-    auto diff_ab_joined = diff_ab.join();
-    auto diff_ba_joined = diff_ba.join();
+    detail::ScratchVector<typename decltype(diff_ab)::CharT> diff_ab_buffer;
+    detail::ScratchVector<typename decltype(diff_ba)::CharT> diff_ba_buffer;
+    auto& diff_ab_joined = *diff_ab_buffer;
+    auto& diff_ba_joined = *diff_ba_buffer;
+    diff_ab.join(diff_ab_joined);
+    diff_ba.join(diff_ba_joined);
 
     size_t ab_len = diff_ab_joined.size();
     size_t ba_len = diff_ba_joined.size();
@@ -530,8 +634,12 @@ double token_ratio(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 la
 
     if (!intersect.empty() && (diff_ab.empty() || diff_ba.empty())) return 100;
 
-    auto diff_ab_joined = diff_ab.join();
-    auto diff_ba_joined = diff_ba.join();
+    detail::ScratchVector<typename decltype(diff_ab)::CharT> diff_ab_buffer;
+    detail::ScratchVector<typename decltype(diff_ba)::CharT> diff_ba_buffer;
+    auto& diff_ab_joined = *diff_ab_buffer;
+    auto& diff_ba_joined = *diff_ba_buffer;
+    diff_ab.join(diff_ab_joined);
+    diff_ba.join(diff_ba_joined);
 
     size_t ab_len = diff_ab_joined.size();
     size_t ba_len = diff_ba_joined.size();
@@ -587,8 +695,12 @@ double token_ratio(const rapidfuzz::detail::SplittedSentenceView<CharT1>& s1_tok
 
     if (!intersect.empty() && (diff_ab.empty() || diff_ba.empty())) return 100;
 
-    auto diff_ab_joined = diff_ab.join();
-    auto diff_ba_joined = diff_ba.join();
+    detail::ScratchVector<typename decltype(diff_ab)::CharT> diff_ab_buffer;
+    detail::ScratchVector<typename decltype(diff_ba)::CharT> diff_ba_buffer;
+    auto& diff_ab_joined = *diff_ab_buffer;
+    auto& diff_ba_joined = *diff_ba_buffer;
+    diff_ab.join(diff_ab_joined);
+    diff_ba.join(diff_ba_joined);
 
     size_t ab_len = diff_ab_joined.size();
     size_t ba_len = diff_ba_joined.size();
@@ -638,8 +750,12 @@ double token_ratio(const std::vector<CharT1>& s1_sorted,
 
     if (!intersect.empty() && (diff_ab.empty() || diff_ba.empty())) return 100;
 
-    auto diff_ab_joined = diff_ab.join();
-    auto diff_ba_joined = diff_ba.join();
+    detail::ScratchVector<typename decltype(diff_ab)::CharT> diff_ab_buffer;
+    detail::ScratchVector<typename decltype(diff_ba)::CharT> diff_ba_buffer;
+    auto& diff_ab_joined = *diff_ab_buffer;
+    auto& diff_ba_joined = *diff_ba_buffer;
+    diff_ab.join(diff_ab_joined);
+    diff_ba.join(diff_ba_joined);
 
     size_t ab_len = diff_ab_joined.size();
     size_t ba_len = diff_ba_joined.size();
@@ -0,0 +1,209 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright © 2022-present Max Bachmann */
+
+#pragma once
+#include <algorithm>
+#include <limits>
+#include <rapidfuzz/distance.hpp>
+#include <type_traits>
+#include <vector>
+
+namespace rapidfuzz::experimental {
+
+enum class PairMetric {
+    Levenshtein,
+    Indel,
+    LCSseq,
+    OSA,
+    DamerauLevenshtein,
+    Jaro,
+    JaroWinkler
+};
+
+/**
+ * @brief computes a set of metrics between the same two strings in one pass.
+ *
+ * The common affix does not affect Levenshtein, Indel, LCSseq, OSA and Damerau-Levenshtein,
+ * so it is removed only once and the pattern match vector of the shorter remainder is shared
+ * by the bit-parallel metrics. Jaro-Winkler reuses the Jaro similarity and the common prefix.
+ */
+class PairMetrics {
+public:
+    explicit PairMetrics(std::vector<PairMetric> metrics, double prefix_weight = 0.1)
+        : m_metrics(std::move(metrics)), m_prefix_weight(prefix_weight)
+    {
+        for (auto metric : m_metrics) {
+            switch (metric) {
+            case PairMetric::Levenshtein: m_levenshtein = true; break;
+            case PairMetric::Indel:
+            case PairMetric::LCSseq: m_lcs = true; break;
+            case PairMetric::OSA: m_osa = true; break;
+            case PairMetric::DamerauLevenshtein: m_damerau = true; break;
+            case PairMetric::Jaro:
+            case PairMetric::JaroWinkler: m_jaro = true; break;
+            }
+        }
+    }
+
+    /**
+     * @brief number of scores written by scores()
+     */
+    size_t size() const noexcept
+    {
+        return m_metrics.size();
+    }
+
+    /**
+     * @brief pattern match vectors for strings longer than 64 characters. A thread
+     * scoring many pairs passes the same workspace to every call of scores(), so
+     * their memory is reused instead of being allocated for every pair
+     */
+    struct Workspace {
+        detail::BlockPatternMatchVector edit{0};
+        detail::BlockPatternMatchVector jaro{0};
+    };
+
+    /**
+     * @brief writes one score per metric in the order passed to the constructor.
+     * These are distances for the edit based metrics and similarities for Jaro and
+     * Jaro-Winkler, or normalized similarities between 0 and 1 for all metrics when
+     * normalized is set.
+     */
+    template <typename Sentence1, typename Sentence2>
+    void scores(double* out, const Sentence1& s1, const Sentence2& s2, bool normalized = false) const
+    {
+        Workspace workspace;
+        scores(out, detail::Range(s1), detail::Range(s2), workspace, normalized);
+    }
+
+    template <typename Sentence1, typename Sentence2>
+    void scores(double* out, const Sentence1& s1, const Sentence2& s2, Workspace& workspace,
+                bool normalized = false) const
+    {
+        scores(out, detail::Range(s1), detail::Range(s2), workspace, normalized);
+    }
+
+    template <typename InputIt1, typename InputIt2>
+    void scores(double* out, const detail::Range<InputIt1>& s1, const detail::Range<InputIt2>& s2,
+                Workspace& workspace, bool normalized = false) const
+    {
+        size_t len1 = s1.size();
+        size_t len2 = s2.size();
+        size_t max_len = std::max(len1, len2);
+
+        double jaro = 0.0;
+        if (m_jaro) {
+            if (len1 <= 64 && len2 <= 64)
+                jaro = detail::jaro_similarity(s1, s2, 0.0);
+            else {
+                workspace.jaro.reset(s1);
+                jaro = detail::jaro_similarity(workspace.jaro, s1, s2, 0.0);
+            }
+        }
+
+        auto P = s1;
+        auto T = s2;
+        auto affix = detail::remove_common_affix(P, T);
+
+        EditScores edit;
+        if (P.size() <= T.size())
+            edit = edit_scores(P, T, workspace);
+        else
+            edit = edit_scores(T, P, workspace);
+
+        size_t lcs = edit.lcs + affix.prefix_len + affix.suffix_len;
+
+        auto write = [&](size_t i, size_t dist, size_t maximum) {
+            if (!normalized)
+                out[i] = static_cast<double>(dist);
+            else
+                out[i] = maximum ? 1.0 - static_cast<double>(dist) / static_cast<double>(maximum) : 1.0;
+        };
+
+        for (size_t i = 0; i < m_metrics.size(); ++i) {
+            switch (m_metrics[i]) {
+            case PairMetric::Levenshtein: write(i, edit.levenshtein, max_len); break;
+            case PairMetric::Indel: write(i, len1 + len2 - 2 * lcs, len1 + len2); break;
+            case PairMetric::LCSseq: write(i, max_len - lcs, max_len); break;
+            case PairMetric::OSA: write(i, edit.osa, max_len); break;
+            case PairMetric::DamerauLevenshtein: write(i, edit.damerau, max_len); break;
+            case PairMetric::Jaro: out[i] = jaro; break;
+            case PairMetric::JaroWinkler:
+            {
+                double sim = jaro;
+                if (sim > 0.7) {
+                    size_t prefix = std::min(affix.prefix_len, size_t(4));
+                    sim += static_cast<double>(prefix) * m_prefix_weight * (1.0 - sim);
+                    sim = std::min(sim, 1.0);
+                }
+                out[i] = sim;
+                break;
+            }
+            }
+        }
+    }
+
+private:
+    struct EditScores {
+        size_t levenshtein = 0;
+        size_t lcs = 0;
+        size_t osa = 0;
+        size_t damerau = 0;
+    };
+
+    /* P is the shorter string after the common affix is removed */
+    template <typename InputIt1, typename InputIt2>
+    EditScores edit_scores(const detail::Range<InputIt1>& P, const detail::Range<InputIt2>& T,
+                           Workspace& workspace) const
+    {
+        EditScores res;
+        if (m_damerau) res.damerau = detail::damerau_levenshtein_distance(P, T, T.size());
+
+        if (P.empty()) {
+            res.levenshtein = T.size();
+            res.osa = T.size();
+        }
+        /* osa_hyrroe2003 requires one spare bit */
+        else if (P.size() < 64)
+            edit_scores(res, detail::PatternMatchVector(P), P, T);
+        else {
+            workspace.edit.reset(P);
+            edit_scores(res, workspace.edit, P, T);
+        }
+
+        return res;
+    }
+
+    template <typename PM_Vec, typename InputIt1, typename InputIt2>
+    void edit_scores(EditScores& res, const PM_Vec& PM, const detail::Range<InputIt1>& P,
+                     const detail::Range<InputIt2>& T) const
+    {
+        constexpr bool single_word = std::is_same_v<PM_Vec, detail::PatternMatchVector>;
+
+        if (m_levenshtein) {
+            if constexpr (single_word)
+                res.levenshtein = detail::levenshtein_hyrroe2003<false, false>(PM, P, T, T.size()).dist;
+            else
+                res.levenshtein = detail::levenshtein_hyrroe2003_block<false, false>(PM, P, T, T.size()).dist;
+        }
+
+        if (m_lcs) res.lcs = detail::longest_common_subsequence(PM, P, T, 0);
+
+        if (m_osa) {
+            if constexpr (single_word)
+                res.osa = detail::osa_hyrroe2003(PM, P, T, T.size());
+            else
+                res.osa = detail::osa_hyrroe2003_block(PM, P, T, T.size());
+        }
+    }
+
+    std::vector<PairMetric> m_metrics;
+    double m_prefix_weight;
+    bool m_levenshtein = false;
+    bool m_lcs = false;
+    bool m_osa = false;
+    bool m_damerau = false;
+    bool m_jaro = false;
+};
+
+} // namespace rapidfuzz::experimental
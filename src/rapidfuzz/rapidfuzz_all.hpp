@@ -2,5 +2,8 @@
 /* Copyright © 2022-present Max Bachmann */
 
 #pragma once
+#include <rapidfuzz/batch.hpp>
 #include <rapidfuzz/distance.hpp>
 #include <rapidfuzz/fuzz.hpp>
+#include <rapidfuzz/metrics.hpp>
+#include <rapidfuzz/tokens.hpp>
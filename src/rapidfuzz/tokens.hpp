@@ -0,0 +1,604 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright © 2022-present Max Bachmann */
+
+#pragma once
+#include <rapidfuzz/distance/Indel.hpp>
+#include <rapidfuzz/fuzz.hpp>
+
+#include <algorithm>
+#include <optional>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace rapidfuzz {
+
+namespace detail {
+
+/**
+ * @brief calls func with every whitespace separated token of [first, last)
+ * in the order they appear. This is the split performed by sorted_split
+ * without the sort
+ */
+template <typename InputIt, typename Func>
+void split_tokens(InputIt first, InputIt last, Func&& func)
+{
+    using CharT = iter_value_t<InputIt>;
+    auto second = first;
+
+    for (; first != last; first = second + 1) {
+        second = std::find_if(first, last, is_space<CharT>);
+
+        if (first != second) func(Range(first, second));
+
+        if (second == last) break;
+    }
+}
+
+/**
+ * @brief length of the tokens joined with a single whitespace
+ */
+static inline size_t joined_length(size_t token_count, size_t char_count)
+{
+    return token_count ? char_count + token_count - 1 : 0;
+}
+
+} // namespace detail
+
+namespace experimental {
+
+/**
+ * @brief dictionary mapping whitespace separated tokens to dense 32 bit ids
+ *
+ * Equal tokens always receive the same id, so comparing tokens becomes an
+ * integer comparison. After update_ranks() the lexicographic order of all
+ * interned tokens is known as well, so sorting tokens only compares integers.
+ */
+template <typename CharT>
+class TokenDictionary {
+public:
+    static constexpr uint32_t npos = static_cast<uint32_t>(-1);
+
+    TokenDictionary() : m_offsets{0}, m_slots(64, 0)
+    {}
+
+    size_t size() const
+    {
+        return m_offsets.size() - 1;
+    }
+
+    size_t token_length(uint32_t id) const
+    {
+        return m_offsets[id + 1] - m_offsets[id];
+    }
+
+    detail::Range<const CharT*> token(uint32_t id) const
+    {
+        return detail::Range(m_chars.data() + m_offsets[id], m_chars.data() + m_offsets[id + 1]);
+    }
+
+    /**
+     * @brief id of the token or npos when it was never interned
+     */
+    template <typename InputIt>
+    uint32_t find(const detail::Range<InputIt>& s) const
+    {
+        uint64_t h = hash(s);
+        size_t mask = m_slots.size() - 1;
+        for (size_t i = static_cast<size_t>(h) & mask;; i = (i + 1) & mask) {
+            uint32_t slot = m_slots[i];
+            if (!slot) return npos;
+            if (m_hashes[slot - 1] == h && equal(slot - 1, s)) return slot - 1;
+        }
+    }
+
+    /**
+     * @brief id of the token. Tokens that are not part of the dictionary yet are added
+     */
+    template <typename InputIt>
+    uint32_t intern(const detail::Range<InputIt>& s)
+    {
+        uint64_t h = hash(s);
+        size_t mask = m_slots.size() - 1;
+        size_t i = static_cast<size_t>(h) & mask;
+        for (;; i = (i + 1) & mask) {
+            uint32_t slot = m_slots[i];
+            if (!slot) break;
+            if (m_hashes[slot - 1] == h && equal(slot - 1, s)) return slot - 1;
+        }
+
+        uint32_t id = static_cast<uint32_t>(size());
+        for (const auto& ch : s)
+            m_chars.push_back(static_cast<CharT>(ch));
+        m_offsets.push_back(m_chars.size());
+        m_hashes.push_back(h);
+        m_slots[i] = id + 1;
+
+        if (2 * size() >= m_slots.size()) grow();
+        return id;
+    }
+
+    /**
+     * @brief appends the ids of the whitespace separated tokens of [first, last)
+     * to ids in the order they appear, interning new tokens
+     */
+    template <typename InputIt>
+    void tokenize(InputIt first, InputIt last, std::vector<uint32_t>& ids)
+    {
+        detail::split_tokens(first, last, [&](const auto& token) { ids.push_back(intern(token)); });
+    }
+
+    /**
+     * @brief assign every token its position in the lexicographic order of all tokens
+     */
+    void update_ranks()
+    {
+        std::vector<uint32_t> ids(size());
+        for (size_t i = 0; i < ids.size(); ++i)
+            ids[i] = static_cast<uint32_t>(i);
+
+        std::sort(ids.begin(), ids.end(), [&](uint32_t a, uint32_t b) { return token(a) < token(b); });
+
+        m_ranks.resize(ids.size());
+        for (size_t i = 0; i < ids.size(); ++i)
+            m_ranks[ids[i]] = static_cast<uint32_t>(i);
+    }
+
+    /**
+     * @brief lexicographic order of two tokens. Tokens interned after the last
+     * update_ranks() are compared character by character
+     */
+    bool less(uint32_t a, uint32_t b) const
+    {
+        if (a < m_ranks.size() && b < m_ranks.size()) return m_ranks[a] < m_ranks[b];
+        return token(a) < token(b);
+    }
+
+private:
+    template <typename InputIt>
+    static uint64_t hash(const detail::Range<InputIt>& s)
+    {
+        /* FNV-1a */
+        uint64_t h = 0xcbf29ce484222325ULL;
+        for (const auto& ch : s) {
+            h ^= static_cast<uint64_t>(static_cast<CharT>(ch));
+            h *= 0x100000001b3ULL;
+        }
+        return h;
+    }
+
+    template <typename InputIt>
+    bool equal(uint32_t id, const detail::Range<InputIt>& s) const
+    {
+        auto t = token(id);
+        return t.size() == s.size() && std::equal(t.begin(), t.end(), s.begin(), [](CharT a, auto b) {
+                   return a == static_cast<CharT>(b);
+               });
+    }
+
+    void grow()
+    {
+        std::vector<uint32_t> slots(m_slots.size() * 2, 0);
+        size_t mask = slots.size() - 1;
+        for (size_t id = 0; id < size(); ++id) {
+            size_t i = static_cast<size_t>(m_hashes[id]) & mask;
+            while (slots[i])
+                i = (i + 1) & mask;
+            slots[i] = static_cast<uint32_t>(id + 1);
+        }
+        m_slots = std::move(slots);
+    }
+
+    std::vector<CharT> m_chars;
+    std::vector<size_t> m_offsets;
+    std::vector<uint64_t> m_hashes;
+    std::vector<uint32_t> m_ranks;
+    /* open addressing table storing id + 1, while 0 marks an empty slot */
+    std::vector<uint32_t> m_slots;
+};
+
+/**
+ * @brief renumbers the token ids of two sequences to 0, 1, 2 ... in the order
+ * of their first occurrence
+ *
+ * Ids below 256 are looked up in the table of the pattern match vectors, while
+ * larger ids go through their hashmap. Sequences sharing a large dictionary
+ * usually contain less than 256 distinct tokens, so after renumbering the
+ * word level metrics take the same path as extended ASCII strings.
+ */
+class TokenIdCompactor {
+public:
+    void operator()(std::vector<uint32_t>& a, std::vector<uint32_t>& b)
+    {
+        uint32_t next_id = 0;
+        auto remap = [&](uint32_t& id) {
+            if (id >= m_local.size()) m_local.resize(static_cast<size_t>(id) + 1, npos);
+            if (m_local[id] == npos) {
+                m_local[id] = next_id++;
+                m_touched.push_back(id);
+            }
+            id = m_local[id];
+        };
+
+        std::for_each(a.begin(), a.end(), remap);
+        std::for_each(b.begin(), b.end(), remap);
+
+        for (uint32_t id : m_touched)
+            m_local[id] = npos;
+        m_touched.clear();
+    }
+
+private:
+    static constexpr uint32_t npos = static_cast<uint32_t>(-1);
+
+    std::vector<uint32_t> m_local;
+    std::vector<uint32_t> m_touched;
+};
+
+/**
+ * @brief a batch of strings split into interned tokens
+ *
+ * Every string is stored as its deduplicated tokens in lexicographic order,
+ * the same tokens sorted by id for the set operations and the sorted tokens
+ * joined with whitespaces, which is the string token_sort_ratio compares.
+ * All of them live in a few flat buffers instead of one allocation per string.
+ */
+template <typename CharT>
+class TokenizedChoices {
+public:
+    template <typename Sentence>
+    explicit TokenizedChoices(const std::vector<Sentence>& strings)
+        : TokenizedChoices(strings.begin(), strings.end())
+    {}
+
+    template <typename InputIt>
+    TokenizedChoices(InputIt first, InputIt last)
+    {
+        std::vector<uint32_t> ids;
+        std::vector<size_t> id_offsets{0};
+        for (auto it = first; it != last; ++it) {
+            m_dict.tokenize(detail::to_begin(*it), detail::to_end(*it), ids);
+            id_offsets.push_back(ids.size());
+        }
+
+        /* sorting the tokens of each string only compares integers from here on */
+        m_dict.update_ranks();
+
+        m_token_offsets.push_back(0);
+        m_joined_offsets.push_back(0);
+        for (size_t i = 0; i + 1 < id_offsets.size(); ++i) {
+            auto tokens_first = ids.begin() + static_cast<ptrdiff_t>(id_offsets[i]);
+            auto tokens_last = ids.begin() + static_cast<ptrdiff_t>(id_offsets[i + 1]);
+            std::sort(tokens_first, tokens_last, [&](uint32_t a, uint32_t b) { return m_dict.less(a, b); });
+
+            for (auto token = tokens_first; token != tokens_last; ++token) {
+                if (token != tokens_first) m_joined.push_back(static_cast<CharT>(0x20));
+                auto chars = m_dict.token(*token);
+                m_joined.insert(m_joined.end(), chars.begin(), chars.end());
+            }
+            m_joined_offsets.push_back(m_joined.size());
+            m_word_counts.push_back(static_cast<size_t>(std::distance(tokens_first, tokens_last)));
+
+            tokens_last = std::unique(tokens_first, tokens_last);
+            size_t char_count = 0;
+            for (auto token = tokens_first; token != tokens_last; ++token)
+                char_count += m_dict.token_length(*token);
+            m_unique_lengths.push_back(
+                detail::joined_length(static_cast<size_t>(std::distance(tokens_first, tokens_last)), char_count));
+
+            m_unique.insert(m_unique.end(), tokens_first, tokens_last);
+            m_sets.insert(m_sets.end(), tokens_first, tokens_last);
+            std::sort(m_sets.end() - std::distance(tokens_first, tokens_last), m_sets.end());
+            m_token_offsets.push_back(m_unique.size());
+        }
+    }
+
+    size_t size() const
+    {
+        return m_unique_lengths.size();
+    }
+
+    const TokenDictionary<CharT>& dictionary() const
+    {
+        return m_dict;
+    }
+
+    /**
+     * @brief deduplicated tokens of string i in lexicographic order
+     */
+    detail::Range<const uint32_t*> unique_tokens(size_t i) const
+    {
+        return detail::Range(m_unique.data() + m_token_offsets[i], m_unique.data() + m_token_offsets[i + 1]);
+    }
+
+    /**
+     * @brief deduplicated tokens of string i sorted by their id
+     */
+    detail::Range<const uint32_t*> token_set(size_t i) const
+    {
+        return detail::Range(m_sets.data() + m_token_offsets[i], m_sets.data() + m_token_offsets[i + 1]);
+    }
+
+    /**
+     * @brief number of tokens of string i including duplicates
+     */
+    size_t word_count(size_t i) const
+    {
+        return m_word_counts[i];
+    }
+
+    /**
+     * @brief length of the deduplicated tokens joined with whitespaces
+     */
+    size_t unique_length(size_t i) const
+    {
+        return m_unique_lengths[i];
+    }
+
+    /**
+     * @brief all tokens of string i sorted and joined with whitespaces
+     */
+    detail::Range<const CharT*> sorted_join(size_t i) const
+    {
+        return detail::Range(m_joined.data() + m_joined_offsets[i], m_joined.data() + m_joined_offsets[i + 1]);
+    }
+
+private:
+    TokenDictionary<CharT> m_dict;
+    std::vector<uint32_t> m_unique;
+    std::vector<uint32_t> m_sets;
+    std::vector<size_t> m_token_offsets;
+    std::vector<size_t> m_word_counts;
+    std::vector<size_t> m_unique_lengths;
+    std::vector<CharT> m_joined;
+    std::vector<size_t> m_joined_offsets;
+};
+
+template <typename Sentence>
+explicit TokenizedChoices(const std::vector<Sentence>& strings) -> TokenizedChoices<char_type<Sentence>>;
+
+/**
+ * @brief token_sort_ratio, token_set_ratio, token_ratio and partial_token_ratio of one query
+ * against the strings of a TokenizedChoices
+ *
+ * The query is split and looked up in the dictionary of the choices once.
+ * Afterwards the set decomposition of a pair is a merge of two sorted id
+ * lists and only the lengths of the intersection and the differences are
+ * calculated. The differences are joined into strings only when the indel
+ * distance between them can still reach the score_cutoff, reusing the same
+ * two buffers for all choices. The results are the same as the ones of
+ * fuzz::token_sort_ratio, fuzz::token_set_ratio, fuzz::token_ratio and
+ * fuzz::partial_token_ratio.
+ *
+ * Since these buffers are shared, an instance must not be used by multiple
+ * threads at once.
+ */
+template <typename CharT>
+class TokenQuery {
+public:
+    template <typename Sentence>
+    TokenQuery(const TokenizedChoices<CharT>& choices, const Sentence& s)
+        : TokenQuery(choices, detail::to_begin(s), detail::to_end(s))
+    {}
+
+    template <typename InputIt>
+    TokenQuery(const TokenizedChoices<CharT>& choices, InputIt first, InputIt last)
+        : m_choices(&choices), m_sorted_join(make_sorted_join(first, last)), m_cached_ratio(m_sorted_join)
+    {
+        const auto& dict = choices.dictionary();
+        std::vector<CharT> text;
+        for (auto it = first; it != last; ++it)
+            text.push_back(static_cast<CharT>(*it));
+
+        auto tokens = detail::sorted_split(text.begin(), text.end());
+        m_word_count = tokens.word_count();
+        tokens.dedupe();
+
+        uint32_t unknown_id = static_cast<uint32_t>(dict.size());
+        size_t char_count = 0;
+        for (const auto& token : tokens.words()) {
+            uint32_t id = dict.find(token);
+            if (id == TokenDictionary<CharT>::npos) id = unknown_id++;
+
+            m_ids.push_back(id);
+            m_token_offsets.push_back(m_chars.size());
+            m_chars.insert(m_chars.end(), token.begin(), token.end());
+            char_count += token.size();
+        }
+        m_token_offsets.push_back(m_chars.size());
+        m_unique_length = detail::joined_length(m_ids.size(), char_count);
+
+        m_set = m_ids;
+        std::sort(m_set.begin(), m_set.end());
+    }
+
+    double token_sort_ratio(size_t i, double score_cutoff = 0) const
+    {
+        if (score_cutoff > 100) return 0;
+
+        return m_cached_ratio.similarity(m_choices->sorted_join(i), score_cutoff);
+    }
+
+    double token_set_ratio(size_t i, double score_cutoff = 0) const
+    {
+        if (score_cutoff > 100) return 0;
+
+        /* in FuzzyWuzzy this returns 0. For sake of compatibility return 0 here as well
+         * see https://github.com/rapidfuzz/RapidFuzz/issues/110 */
+        if (m_ids.empty() || m_choices->unique_tokens(i).empty()) return 0;
+
+        return set_ratio(i, score_cutoff, 0);
+    }
+
+    double token_ratio(size_t i, double score_cutoff = 0) const
+    {
+        if (score_cutoff > 100) return 0;
+
+        return set_ratio(i, score_cutoff, -1);
+    }
+
+    double partial_token_ratio(size_t i, double score_cutoff = 0) const
+    {
+        if (score_cutoff > 100) return 0;
+
+        size_t sect_chars = 0;
+        // exit early when there is a common word in both sequences
+        if (intersection(i, sect_chars)) return 100;
+
+        if (!m_cached_partial_sorted) m_cached_partial_sorted.emplace(m_sorted_join);
+        double result = m_cached_partial_sorted->similarity(m_choices->sorted_join(i), score_cutoff);
+
+        // do not calculate the same partial_ratio twice
+        if (m_word_count == m_ids.size() && m_choices->word_count(i) == m_choices->unique_tokens(i).size())
+            return result;
+
+        /* without an intersection the differences are the deduplicated tokens */
+        score_cutoff = std::max(score_cutoff, result);
+        join_difference(i);
+        return std::max(result, fuzz::partial_ratio(m_diff_ab, m_diff_ba, score_cutoff));
+    }
+
+private:
+    template <typename InputIt>
+    static std::vector<CharT> make_sorted_join(InputIt first, InputIt last)
+    {
+        std::vector<CharT> text;
+        for (auto it = first; it != last; ++it)
+            text.push_back(static_cast<CharT>(*it));
+
+        return detail::sorted_split(text.begin(), text.end()).join();
+    }
+
+    /**
+     * @brief merges the two id sets to get the number of tokens both strings
+     * have in common and the number of characters in these tokens
+     */
+    size_t intersection(size_t i, size_t& sect_chars) const
+    {
+        const auto& dict = m_choices->dictionary();
+        auto choice_set = m_choices->token_set(i);
+
+        size_t sect_count = 0;
+        auto a = m_set.begin();
+        auto b = choice_set.begin();
+        while (a != m_set.end() && b != choice_set.end()) {
+            if (*a < *b)
+                ++a;
+            else if (*b < *a)
+                ++b;
+            else {
+                ++sect_count;
+                sect_chars += dict.token_length(*a);
+                ++a;
+                ++b;
+            }
+        }
+        return sect_count;
+    }
+
+    /**
+     * @brief shared implementation of token_set_ratio and token_ratio. When
+     * sort_score is negative the token_sort_ratio is calculated as well
+     */
+    double set_ratio(size_t i, double score_cutoff, double sort_score) const
+    {
+        auto choice_set = m_choices->token_set(i);
+
+        size_t sect_chars = 0;
+        size_t sect_count = intersection(i, sect_chars);
+
+        size_t ab_count = m_ids.size() - sect_count;
+        size_t ba_count = choice_set.size() - sect_count;
+
+        if (sect_count && (!ab_count || !ba_count)) return 100;
+
+        size_t sect_len = detail::joined_length(sect_count, sect_chars);
+        /* removing the intersection removes its characters and one whitespace per token */
+        size_t ab_len = sect_count ? (ab_count ? m_unique_length - sect_len - 1 : 0) : m_unique_length;
+        size_t ba_len = sect_count ? (ba_count ? m_choices->unique_length(i) - sect_len - 1 : 0)
+                                   : m_choices->unique_length(i);
+
+        double result = 0;
+        if (sort_score < 0) {
+            result = token_sort_ratio(i, score_cutoff);
+            /* only scores above the token_sort_ratio can change the result */
+            score_cutoff = std::max(score_cutoff, result);
+        }
+
+        // string length sect+ab <-> sect and sect+ba <-> sect
+        size_t sect_ab_len = sect_len + bool(sect_len) + ab_len;
+        size_t sect_ba_len = sect_len + bool(sect_len) + ba_len;
+
+        size_t cutoff_distance = fuzz::fuzz_detail::score_cutoff_to_distance(score_cutoff, sect_ab_len + sect_ba_len);
+        if (detail::abs_diff(ab_len, ba_len) <= cutoff_distance) {
+            join_difference(i);
+            size_t dist = indel_distance(m_diff_ab, m_diff_ba, cutoff_distance);
+            if (dist <= cutoff_distance)
+                result = std::max(
+                    result, fuzz::fuzz_detail::norm_distance(dist, sect_ab_len + sect_ba_len, score_cutoff));
+        }
+
+        // exit early since the other ratios are 0
+        if (!sect_len) return result;
+
+        // levenshtein distance sect+ab <-> sect and sect+ba <-> sect
+        // since only sect is similar in them the distance can be calculated based on
+        // the length difference
+        size_t sect_ab_dist = bool(sect_len) + ab_len;
+        double sect_ab_ratio = fuzz::fuzz_detail::norm_distance(sect_ab_dist, sect_len + sect_ab_len, score_cutoff);
+
+        size_t sect_ba_dist = bool(sect_len) + ba_len;
+        double sect_ba_ratio = fuzz::fuzz_detail::norm_distance(sect_ba_dist, sect_len + sect_ba_len, score_cutoff);
+
+        return std::max({result, sect_ab_ratio, sect_ba_ratio});
+    }
+
+    /**
+     * @brief join the tokens only found in the query and the tokens only
+     * found in choice i, both in lexicographic order
+     */
+    void join_difference(size_t i) const
+    {
+        const auto& dict = m_choices->dictionary();
+        auto choice_set = m_choices->token_set(i);
+
+        m_diff_ab.clear();
+        for (size_t k = 0; k < m_ids.size(); ++k) {
+            if (std::binary_search(choice_set.begin(), choice_set.end(), m_ids[k])) continue;
+
+            if (!m_diff_ab.empty()) m_diff_ab.push_back(static_cast<CharT>(0x20));
+            m_diff_ab.insert(m_diff_ab.end(), m_chars.begin() + static_cast<ptrdiff_t>(m_token_offsets[k]),
+                             m_chars.begin() + static_cast<ptrdiff_t>(m_token_offsets[k + 1]));
+        }
+
+        m_diff_ba.clear();
+        for (uint32_t id : m_choices->unique_tokens(i)) {
+            if (std::binary_search(m_set.begin(), m_set.end(), id)) continue;
+
+            if (!m_diff_ba.empty()) m_diff_ba.push_back(static_cast<CharT>(0x20));
+            auto chars = dict.token(id);
+            m_diff_ba.insert(m_diff_ba.end(), chars.begin(), chars.end());
+        }
+    }
+
+    const TokenizedChoices<CharT>* m_choices;
+    std::vector<CharT> m_sorted_join;
+    fuzz::CachedRatio<CharT> m_cached_ratio;
+    /* only built when partial_token_ratio is used */
+    mutable std::optional<fuzz::CachedPartialRatio<CharT>> m_cached_partial_sorted;
+
+    /* deduplicated query tokens in lexicographic order */
+    std::vector<uint32_t> m_ids;
+    std::vector<CharT> m_chars;
+    std::vector<size_t> m_token_offsets;
+    size_t m_word_count = 0;
+    size_t m_unique_length = 0;
+    /* m_ids sorted by id */
+    std::vector<uint32_t> m_set;
+
+    mutable std::vector<CharT> m_diff_ab;
+    mutable std::vector<CharT> m_diff_ba;
+};
+
+} // namespace experimental
+} // namespace rapidfuzz
@@ -0,0 +1,315 @@
+#include <Rcpp.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "rapidfuzz_batch.h"
+#include "rapidfuzz_pool.h"
+#include <rapidfuzz/tokens.hpp>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifndef SIZE_MAX
+#define SIZE_MAX static_cast<size_t>(-1)
+#endif
+
+using namespace Rcpp;
+
+//' @name batch_distance
+//' @title Batch Distance
+//' @description Calculates the distance between a query string and every string in a vector of choices.
+//' The choices are grouped by length, so short strings are scored in the narrowest SIMD lanes
+//' and whole groups that cannot reach the cutoff are skipped.
+//' @param query The query string.
+//' @param choices A vector of strings or a \code{string_pool} to compare against the query.
+//' @param metric The metric to use ("levenshtein", "indel", "lcs_seq", "osa", "jaro" or "jaro_winkler").
+//' @param score_cutoff Score threshold to stop calculation. Default is the maximum possible value.
+//' @return A numeric vector with one distance per choice. The attribute "prefilter" counts the choices
+//' rejected by the length and character histogram prefilters and the choices that were scored.
+//' @examples
+//' batch_distance("kitten", c("sitting", "kitchen", "mitten"))
+//' @export
+// [[Rcpp::export]]
+ Rcpp::NumericVector batch_distance(const std::string& query,
+                                    SEXP choices,
+                                    std::string metric = "levenshtein",
+                                    Rcpp::Nullable<double> score_cutoff = R_NilValue) {
+   StringPoolArg pool(choices);
+
+   return visitPoolQuery(*pool, query, [&](auto tag, const auto& queryChars) {
+     using CharT = decltype(tag);
+
+     return dispatchMetric(metric, [&](auto m) {
+       using Metric = decltype(m);
+       using ResType = typename Metric::ResType;
+
+       ResType cutoff_value = score_cutoff.isNull()
+         ? (std::is_floating_point<ResType>::value ? ResType(1) : std::numeric_limits<ResType>::max())
+         : Rcpp::as<ResType>(score_cutoff);
+
+       rapidfuzz::experimental::BatchScorer<CharT, Metric> scorer(pool->views<CharT>(), m);
+       std::vector<ResType> scores(pool->size());
+       scorer.distance(scores.data(), scores.size(), queryChars, cutoff_value);
+
+       Rcpp::NumericVector result(scores.begin(), scores.end());
+       result.attr("prefilter") = prefilterCounts(scorer.prefilter_stats());
+       return result;
+     });
+   });
+ }
+
+//' @name batch_normalized_similarity
+//' @title Batch Normalized Similarity
+//' @description Calculates the normalized similarity between a query string and every string in a vector
+//' of choices. The choices are grouped by length, so short strings are scored in the narrowest SIMD lanes
+//' and whole groups that cannot reach the cutoff are skipped.
+//' @param query The query string.
+//' @param choices A vector of strings or a \code{string_pool} to compare against the query.
+//' @param metric The metric to use ("levenshtein", "indel", "lcs_seq", "osa", "jaro" or "jaro_winkler").
+//' @param score_cutoff Score threshold to stop calculation. Default is 0.0.
+//' @return A numeric vector with one normalized similarity between 0 and 1 per choice. The attribute
+//' "prefilter" counts the choices rejected by the length and character histogram prefilters and the choices
+//' that were scored.
+//' @examples
+//' batch_normalized_similarity("kitten", c("sitting", "kitchen", "mitten"))
+//' @export
+// [[Rcpp::export]]
+ Rcpp::NumericVector batch_normalized_similarity(const std::string& query,
+                                                 SEXP choices,
+                                                 std::string metric = "levenshtein",
+                                                 double score_cutoff = 0.0) {
+   StringPoolArg pool(choices);
+
+   return visitPoolQuery(*pool, query, [&](auto tag, const auto& queryChars) {
+     using CharT = decltype(tag);
+
+     return dispatchMetric(metric, [&](auto m) {
+       rapidfuzz::experimental::BatchScorer<CharT, decltype(m)> scorer(pool->views<CharT>(), m);
+       Rcpp::NumericVector scores(pool->size());
+       scorer.normalized_similarity(scores.begin(), scores.size(), queryChars, score_cutoff);
+       scores.attr("prefilter") = prefilterCounts(scorer.prefilter_stats());
+       return scores;
+     });
+   });
+ }
+
+//' @name batch_token_ratio
+//' @title Batch Token Ratio
+//' @description Calculates a token based ratio between every query and every choice. The tokens of all
+//' choices are interned into a shared dictionary of integer ids once, so sorting the tokens and splitting
+//' them into intersection and differences only compares integers. The differences are joined into strings
+//' only when their similarity can still reach the cutoff.
+//' @param queries A vector of query strings or a \code{string_pool}.
+//' @param choices A vector of strings or a \code{string_pool} to compare against the queries.
+//' @param scorer The token ratio to use ("token_sort_ratio", "token_set_ratio" or "token_ratio").
+//' @param score_cutoff Score threshold between 0 and 100. Scores below it are returned as 0. Default is 0.0.
+//' @return A numeric matrix with one row per query and one column per choice. The scores are the same as
+//' the ones of \code{fuzz_token_sort_ratio}, \code{fuzz_token_set_ratio} and \code{fuzz_token_ratio}.
+//' @examples
+//' batch_token_ratio(c("fuzzy wuzzy was a bear", "new york"),
+//'                   c("wuzzy fuzzy was a bear", "york new", "bear"))
+//' @export
+// [[Rcpp::export]]
+ Rcpp::NumericMatrix batch_token_ratio(SEXP queries,
+                                       SEXP choices,
+                                       std::string scorer = "token_ratio",
+                                       double score_cutoff = 0.0) {
+   if (scorer != "token_sort_ratio" && scorer != "token_set_ratio" && scorer != "token_ratio") {
+     Rcpp::stop("Invalid scorer specified.");
+   }
+
+   StringPoolArg queryPool(queries);
+   StringPoolArg choicePool(choices);
+   Rcpp::NumericMatrix result(queryPool->size(), choicePool->size());
+
+   visitPools(*queryPool, *choicePool, [&](auto queryTag, auto choiceTag) {
+     using QueryT = decltype(queryTag);
+     using CharT = decltype(choiceTag);
+     // the tokens of queries and choices are compared in one type holding the characters of both
+     using TokenT = CommonChar<QueryT, CharT>;
+     using rapidfuzz::experimental::TokenQuery;
+
+     double (TokenQuery<TokenT>::*score)(size_t, double) const = &TokenQuery<TokenT>::token_ratio;
+     if (scorer == "token_sort_ratio") {
+       score = &TokenQuery<TokenT>::token_sort_ratio;
+     } else if (scorer == "token_set_ratio") {
+       score = &TokenQuery<TokenT>::token_set_ratio;
+     }
+
+     auto views = choicePool->views<CharT>();
+     rapidfuzz::experimental::TokenizedChoices<TokenT> tokenized(views.begin(), views.end());
+
+     for (size_t q = 0; q < queryPool->size(); ++q) {
+       TokenQuery<TokenT> query(tokenized, queryPool->chars<QueryT>(q));
+       for (size_t i = 0; i < choicePool->size(); ++i) {
+         result(q, i) = (query.*score)(i, score_cutoff);
+       }
+     }
+   });
+
+   return result;
+ }
+
+//' @name batch_fixed_point_similarity
+//' @title Batch Fixed Point Similarity
+//' @description Calculates the normalized similarity between every query and every choice as an integer
+//' between 0 and 10000, which is the normalized similarity multiplied by 10000 and rounded down. The
+//' cutoff is converted into a maximum distance for every string length, so the scoring does not use any
+//' floating point arithmetic and the scores are stored in 16 bit internally. For the "indel" metric the
+//' scores are \code{fuzz_ratio} multiplied by 100.
+//' @param queries A vector of query strings or a \code{string_pool}.
+//' @param choices A vector of strings or a \code{string_pool} to compare against the queries.
+//' @param metric The metric to use ("levenshtein", "indel", "lcs_seq" or "osa").
+//' @param score_cutoff Score threshold between 0 and 10000. Scores below it are returned as 0. Default is 0.
+//' @return An integer matrix with one row per query and one column per choice.
+//' @examples
+//' batch_fixed_point_similarity(c("kitten", "mitten"), c("sitting", "kitchen", "mitten"))
+//' @export
+// [[Rcpp::export]]
+ Rcpp::IntegerMatrix batch_fixed_point_similarity(SEXP queries,
+                                                  SEXP choices,
+                                                  std::string metric = "levenshtein",
+                                                  int score_cutoff = 0) {
+   if (score_cutoff < 0 || score_cutoff > 10000) {
+     Rcpp::stop("score_cutoff must be between 0 and 10000.");
+   }
+
+   StringPoolArg queryPool(queries);
+   StringPoolArg choicePool(choices);
+   size_t query_count = queryPool->size();
+   size_t choice_count = choicePool->size();
+
+   return visitPools(*queryPool, *choicePool, [&](auto queryTag, auto choiceTag) {
+     using QueryT = decltype(queryTag);
+     using CharT = decltype(choiceTag);
+
+     return dispatchMetric(metric, [&](auto m) {
+       using Metric = decltype(m);
+       Rcpp::IntegerMatrix result(query_count, choice_count);
+
+       if constexpr (std::is_floating_point<typename Metric::ResType>::value) {
+         Rcpp::stop("Fixed point scores are only supported by the edit distance metrics.");
+       } else {
+         rapidfuzz::experimental::BatchScorer<CharT, Metric> scorer(choicePool->views<CharT>(), m);
+         std::vector<uint16_t> scores(choice_count);
+
+         for (size_t q = 0; q < query_count; ++q) {
+           scorer.fixed_point_similarity(scores.data(), scores.size(), queryPool->chars<QueryT>(q),
+                                         static_cast<uint16_t>(score_cutoff));
+           for (size_t i = 0; i < choice_count; ++i) {
+             result(q, i) = scores[i];
+           }
+         }
+       }
+
+       return result;
+     });
+   });
+ }
+
+//' @name batch_dist
+//' @title Batch Distance Within a Vector
+//' @description Calculates the distance between every pair of strings of one vector, e.g. to cluster a
+//' list of names. The distance is symmetric, so only the pairs \code{i < j} are scored. The pairs are
+//' split into chunks of equal size over the \code{num_threads} threads, so the longer columns of the
+//' triangle do not end up on a single thread, and each string builds its cached scorer once per chunk.
+//' @param strings A vector of strings or a \code{string_pool}.
+//' @param metric The metric to use ("levenshtein", "indel", "lcs_seq", "osa", "jaro" or "jaro_winkler").
+//' @param normalized If TRUE, normalized distances between 0 and 1 are returned. Default is FALSE.
+//' @param format Either "dist" for an object of class \code{dist} or "matrix" for the full symmetric matrix,
+//' whose diagonal holds the distance of each string to itself.
+//' @param num_threads The number of threads to use (default is 1).
+//' @return An object of class \code{dist}, which can be passed to \code{hclust} directly, or a numeric
+//' matrix. The strings are used as labels.
+//' @examples
+//' d <- batch_dist(c("apple", "apples", "appel", "banana", "bananas"))
+//' hclust(d)
+//' batch_dist(c("kitten", "sitting", "mitten"), metric = "indel", format = "matrix")
+//' @export
+// [[Rcpp::export]]
+ SEXP batch_dist(SEXP strings,
+                 std::string metric = "levenshtein",
+                 bool normalized = false,
+                 std::string format = "dist",
+                 int num_threads = 1) {
+   if (format != "dist" && format != "matrix") {
+     Rcpp::stop("Invalid format specified: " + format);
+   }
+
+   StringPoolArg pool(strings);
+   size_t n = pool->size();
+   size_t pair_count = n < 2 ? 0 : n * (n - 1) / 2;
+
+   // the pairs are stored like the lower triangle of a dist object: column j holds the
+   // distances of string j to the strings j + 1, ..., n - 1 and starts at colStart[j]
+   std::vector<size_t> colStart(n);
+   for (size_t j = 1; j < n; ++j) {
+     colStart[j] = colStart[j - 1] + (n - j);
+   }
+
+   std::vector<double> distances(pair_count);
+   std::vector<double> diagonal(format == "matrix" ? n : 0);
+
+   int threads = std::max(num_threads, 1);
+   size_t chunk_count = std::max<size_t>(std::min(pair_count, static_cast<size_t>(threads) * 4), 1);
+
+   pool->visit([&](auto tag) {
+     using CharT = decltype(tag);
+
+     dispatchMetric(metric, [&](auto m) {
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(threads) schedule(dynamic)
+#endif
+       for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+         size_t first = pair_count * chunk / chunk_count;
+         size_t last = pair_count * (chunk + 1) / chunk_count;
+         if (first == last) continue;
+
+         size_t j = static_cast<size_t>(std::upper_bound(colStart.begin(), colStart.end(), first) - colStart.begin()) - 1;
+         size_t k = first;
+         while (k < last) {
+           auto cached = m.make_cached(pool->chars<CharT>(j));
+           size_t col_last = std::min(last, colStart[j] + (n - j - 1));
+           for (; k < col_last; ++k) {
+             auto other = pool->chars<CharT>(j + 1 + (k - colStart[j]));
+             distances[k] = normalized ? cached.normalized_distance(other) : static_cast<double>(cached.distance(other));
+           }
+           ++j;
+         }
+       }
+
+       // only the diagonal of Jaro and Jaro-Winkler for empty strings is not 0
+       for (size_t i = 0; i < diagonal.size(); ++i) {
+         auto chars = pool->chars<CharT>(i);
+         auto cached = m.make_cached(chars);
+         diagonal[i] = normalized ? cached.normalized_distance(chars) : static_cast<double>(cached.distance(chars));
+       }
+     });
+   });
+
+   Rcpp::CharacterVector labels = pool->source();
+
+   if (format == "matrix") {
+     Rcpp::NumericMatrix result(n, n);
+     for (size_t j = 0; j < n; ++j) {
+       result(j, j) = diagonal[j];
+       for (size_t i = j + 1; i < n; ++i) {
+         double dist = distances[colStart[j] + (i - j - 1)];
+         result(i, j) = dist;
+         result(j, i) = dist;
+       }
+     }
+     result.attr("dimnames") = Rcpp::List::create(labels, labels);
+     return result;
+   }
+
+   Rcpp::NumericVector result(distances.begin(), distances.end());
+   result.attr("Size") = static_cast<int>(n);
+   result.attr("Labels") = labels;
+   result.attr("Diag") = false;
+   result.attr("Upper") = false;
+   result.attr("method") = metric;
+   result.attr("class") = "dist";
+   return result;
+ }
@@ -0,0 +1,30 @@
+#ifndef RAPIDFUZZ_BATCH_H
+#define RAPIDFUZZ_BATCH_H
+
+#include <Rcpp.h>
+#include <string>
+#include <rapidfuzz/batch.hpp>
+
+// Calls func with the metric description matching the metric name
+template <typename Func>
+auto dispatchMetric(const std::string& metric, Func&& func) {
+  using namespace rapidfuzz::experimental;
+
+  if (metric == "levenshtein") return func(LevenshteinMetric{});
+  if (metric == "indel") return func(IndelMetric{});
+  if (metric == "lcs_seq") return func(LCSseqMetric{});
+  if (metric == "osa") return func(OSAMetric{});
+  if (metric == "jaro") return func(JaroMetric{});
+  if (metric == "jaro_winkler") return func(JaroWinklerMetric{});
+
+  Rcpp::stop("Invalid metric specified.");
+}
+
+// Named counters of the candidates rejected by each prefilter, attached to results as attr "prefilter"
+inline Rcpp::IntegerVector prefilterCounts(const rapidfuzz::experimental::PrefilterStats& stats) {
+  return Rcpp::IntegerVector::create(Rcpp::Named("length") = static_cast<int>(stats.length),
+                                     Rcpp::Named("histogram") = static_cast<int>(stats.histogram),
+                                     Rcpp::Named("scored") = static_cast<int>(stats.scored));
+}
+
+#endif
@@ -3,6 +3,7 @@
 #include <limits>
 #include <rapidfuzz/details/common.hpp>
 #include <rapidfuzz/distance/DamerauLevenshtein.hpp>
+#include "rapidfuzz_utf8.h"
 
 #ifndef SIZE_MAX
 #define SIZE_MAX static_cast<size_t>(-1)
@@ -27,7 +28,9 @@
 // [[Rcpp::export]]
  size_t damerau_levenshtein_distance(std::string s1, std::string s2, Rcpp::Nullable<double> score_cutoff = R_NilValue) {
    size_t cutoff_value = score_cutoff.isNull() ? std::numeric_limits<size_t>::max() : Rcpp::as<size_t>(score_cutoff);
-   return rapidfuzz::experimental::damerau_levenshtein_distance(s1, s2, cutoff_value);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::experimental::damerau_levenshtein_distance(chars1, chars2, cutoff_value);
+   });
  }
 
 //' @name damerau_levenshtein_similarity
@@ -47,7 +50,9 @@
 //' @export
 // [[Rcpp::export]]
  size_t damerau_levenshtein_similarity(std::string s1, std::string s2, size_t score_cutoff = 0) {
-   return rapidfuzz::experimental::damerau_levenshtein_similarity(s1, s2, score_cutoff);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::experimental::damerau_levenshtein_similarity(chars1, chars2, score_cutoff);
+   });
  }
 
 //' @name damerau_levenshtein_normalized_distance
@@ -67,7 +72,9 @@
 //' @export
 // [[Rcpp::export]]
  double damerau_levenshtein_normalized_distance(std::string s1, std::string s2, double score_cutoff = 1.0) {
-   return rapidfuzz::experimental::damerau_levenshtein_normalized_distance(s1, s2, score_cutoff);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::experimental::damerau_levenshtein_normalized_distance(chars1, chars2, score_cutoff);
+   });
  }
 
 //' @name damerau_levenshtein_normalized_similarity
@@ -87,5 +94,7 @@
 //' @export
 // [[Rcpp::export]]
  double damerau_levenshtein_normalized_similarity(std::string s1, std::string s2, double score_cutoff = 0.0) {
-   return rapidfuzz::experimental::damerau_levenshtein_normalized_similarity(s1, s2, score_cutoff);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::experimental::damerau_levenshtein_normalized_similarity(chars1, chars2, score_cutoff);
+   });
  }
@@ -0,0 +1,299 @@
+#include <Rcpp.h>
+#include <rapidfuzz/distance.hpp>
+#include "rapidfuzz_editops.h"
+#include "rapidfuzz_pool.h"
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace Rcpp;
+
+// Edit operations of every pair of s1 and s2, computed over the threads. The strings are compared as bytes
+// like in get_editops and lcs_seq_editops, and the operations of every pair are kept packed until all
+// pairs are done.
+static std::vector<rapidfuzz::PackedEditops> pairEditops(const Rcpp::CharacterVector& s1,
+                                                         const Rcpp::CharacterVector& s2,
+                                                         const std::string& metric, int num_threads) {
+  if (s1.size() != s2.size()) {
+    Rcpp::stop("s1 and s2 must have the same length.");
+  }
+
+  bool lcs_seq = false;
+  if (metric == "lcs_seq") {
+    lcs_seq = true;
+  } else if (metric != "levenshtein") {
+    Rcpp::stop("Invalid metric specified: " + metric);
+  }
+
+  StringPool pool1(s1, false);
+  StringPool pool2(s2, false);
+  size_t pair_count = pool1.size();
+  std::vector<rapidfuzz::PackedEditops> result(pair_count);
+
+#ifdef _OPENMP
+  int threads = std::max(num_threads, 1);
+#pragma omp parallel for num_threads(threads) schedule(dynamic, 64)
+#endif
+  for (size_t i = 0; i < pair_count; ++i) {
+    auto chars1 = pool1.chars<uint8_t>(i);
+    auto chars2 = pool2.chars<uint8_t>(i);
+    if (lcs_seq) {
+      result[i] = rapidfuzz::PackedEditops(rapidfuzz::detail::lcs_seq_editops(chars1, chars2));
+    } else {
+      result[i] = rapidfuzz::PackedEditops(
+        rapidfuzz::detail::levenshtein_editops(chars1, chars2, std::numeric_limits<size_t>::max()));
+    }
+  }
+
+  return result;
+}
+
+// Position of the first row of every pair in the long format result, plus the total row count
+template <typename Ops>
+static std::vector<size_t> rowOffsets(const std::vector<Ops>& ops) {
+  std::vector<size_t> offsets(ops.size() + 1, 0);
+  for (size_t i = 0; i < ops.size(); ++i) {
+    offsets[i + 1] = offsets[i] + ops[i].size();
+  }
+  return offsets;
+}
+
+//' @name batch_editops
+//' @title Edit Operations for Pairs of Strings
+//' @description Calculates the edit operations between every pair of strings and returns them in one
+//' data frame, e.g. to build change reports for many record updates at once. The pairs are spread over
+//' the threads and stored with 8 bytes per operation until the result is built.
+//' @param s1 A vector of source strings.
+//' @param s2 A vector of target strings with the same length as s1.
+//' @param metric The metric whose edit operations are returned: "levenshtein" (as \code{get_editops}) or
+//' "lcs_seq" (as \code{lcs_seq_editops}).
+//' @param types_as_factor If TRUE, the type column is a factor with the levels "delete", "insert" and
+//' "replace" instead of a character vector.
+//' @param num_threads The number of threads to use (default is 1).
+//' @return A data.frame with one row per edit operation. \code{pair_id} is the 1-based index of the pair,
+//' \code{type} the operation and \code{src_pos} and \code{dest_pos} the 0-based positions in s1 and s2.
+//' @examples
+//' batch_editops(c("kitten", "flaw"), c("sitting", "lawn"))
+//' @export
+// [[Rcpp::export]]
+ Rcpp::DataFrame batch_editops(Rcpp::CharacterVector s1,
+                               Rcpp::CharacterVector s2,
+                               std::string metric = "levenshtein",
+                               bool types_as_factor = false,
+                               int num_threads = 1) {
+   std::vector<rapidfuzz::PackedEditops> ops = pairEditops(s1, s2, metric, num_threads);
+   std::vector<size_t> offsets = rowOffsets(ops);
+   size_t pair_count = ops.size();
+   R_xlen_t rows = static_cast<R_xlen_t>(offsets.back());
+
+   Rcpp::IntegerVector pair_id(rows);
+   Rcpp::IntegerVector src_pos(rows);
+   Rcpp::IntegerVector dest_pos(rows);
+   std::vector<int> types(static_cast<size_t>(rows));
+   int* pair_data = pair_id.begin();
+   int* src_data = src_pos.begin();
+   int* dest_data = dest_pos.begin();
+
+#ifdef _OPENMP
+   int threads = std::max(num_threads, 1);
+#pragma omp parallel for num_threads(threads) schedule(static)
+#endif
+   for (size_t i = 0; i < pair_count; ++i) {
+     for (size_t k = 0, row = offsets[i]; k < ops[i].size(); ++k, ++row) {
+       pair_data[row] = static_cast<int>(i) + 1;
+       types[row] = editTypeCode(ops[i].type(k));
+       src_data[row] = static_cast<int>(ops[i].src_pos(k));
+       dest_data[row] = static_cast<int>(ops[i].dest_pos(k));
+     }
+   }
+
+   return DataFrame::create(
+     Named("pair_id") = pair_id,
+     Named("type") = editTypeColumn(types, types_as_factor),
+     Named("src_pos") = src_pos,
+     Named("dest_pos") = dest_pos
+   );
+ }
+
+//' @name batch_opcodes
+//' @title Opcodes for Pairs of Strings
+//' @description Calculates the opcodes between every pair of strings and returns them in one data frame.
+//' Opcodes describe the same alignment as \code{batch_editops}, but group consecutive operations of the
+//' same type into blocks and include the blocks of equal characters. The pairs are spread over the threads.
+//' @param s1 A vector of source strings.
+//' @param s2 A vector of target strings with the same length as s1.
+//' @param metric The metric whose alignment is returned: "levenshtein" or "lcs_seq".
+//' @param types_as_factor If TRUE, the type column is a factor with the levels "delete", "insert",
+//' "replace" and "equal" instead of a character vector.
+//' @param num_threads The number of threads to use (default is 1).
+//' @return A data.frame with one row per block. \code{pair_id} is the 1-based index of the pair,
+//' \code{type} the operation, and s1[src_begin, src_end) and s2[dest_begin, dest_end) the 0-based,
+//' end exclusive character ranges the block covers.
+//' @examples
+//' batch_opcodes(c("kitten", "flaw"), c("sitting", "lawn"))
+//' @export
+// [[Rcpp::export]]
+ Rcpp::DataFrame batch_opcodes(Rcpp::CharacterVector s1,
+                               Rcpp::CharacterVector s2,
+                               std::string metric = "levenshtein",
+                               bool types_as_factor = false,
+                               int num_threads = 1) {
+   std::vector<rapidfuzz::Opcodes> ops;
+   {
+     std::vector<rapidfuzz::PackedEditops> editops = pairEditops(s1, s2, metric, num_threads);
+     ops.resize(editops.size());
+
+#ifdef _OPENMP
+     int threads = std::max(num_threads, 1);
+#pragma omp parallel for num_threads(threads) schedule(static)
+#endif
+     for (size_t i = 0; i < editops.size(); ++i) {
+       ops[i] = rapidfuzz::Opcodes(editops[i].unpack());
+     }
+   }
+
+   std::vector<size_t> offsets = rowOffsets(ops);
+   size_t pair_count = ops.size();
+   R_xlen_t rows = static_cast<R_xlen_t>(offsets.back());
+
+   Rcpp::IntegerVector pair_id(rows);
+   Rcpp::IntegerVector src_begin(rows);
+   Rcpp::IntegerVector src_end(rows);
+   Rcpp::IntegerVector dest_begin(rows);
+   Rcpp::IntegerVector dest_end(rows);
+   std::vector<int> types(static_cast<size_t>(rows));
+   int* pair_data = pair_id.begin();
+   int* src_begin_data = src_begin.begin();
+   int* src_end_data = src_end.begin();
+   int* dest_begin_data = dest_begin.begin();
+   int* dest_end_data = dest_end.begin();
+
+#ifdef _OPENMP
+   int threads = std::max(num_threads, 1);
+#pragma omp parallel for num_threads(threads) schedule(static)
+#endif
+   for (size_t i = 0; i < pair_count; ++i) {
+     size_t row = offsets[i];
+     for (const auto& op : ops[i]) {
+       pair_data[row] = static_cast<int>(i) + 1;
+       types[row] = opcodeTypeCode(op.type);
+       src_begin_data[row] = static_cast<int>(op.src_begin);
+       src_end_data[row] = static_cast<int>(op.src_end);
+       dest_begin_data[row] = static_cast<int>(op.dest_begin);
+       dest_end_data[row] = static_cast<int>(op.dest_end);
+       ++row;
+     }
+   }
+
+   return DataFrame::create(
+     Named("pair_id") = pair_id,
+     Named("type") = editTypeColumn(types, types_as_factor, opcodeTypeLevels()),
+     Named("src_begin") = src_begin,
+     Named("src_end") = src_end,
+     Named("dest_begin") = dest_begin,
+     Named("dest_end") = dest_end
+   );
+ }
+
+// Rows of every pair of a long format data frame with a pair_id column: the rows of pair i are
+// [offsets[i], offsets[i + 1]). The rows have to be sorted by pair_id, as returned by the batch functions.
+static std::vector<size_t> pairRowOffsets(const Rcpp::DataFrame& frame, size_t pair_count) {
+  Rcpp::IntegerVector pair_id = frame["pair_id"];
+  std::vector<size_t> offsets(pair_count + 1, 0);
+  int previous = 1;
+
+  for (size_t row = 0; row < static_cast<size_t>(pair_id.size()); ++row) {
+    int id = pair_id[row];
+    if (id == NA_INTEGER || id < previous || static_cast<size_t>(id) > pair_count) {
+      Rcpp::stop("pair_id must be sorted and between 1 and the number of strings.");
+    }
+    previous = id;
+    ++offsets[static_cast<size_t>(id)];
+  }
+
+  for (size_t i = 0; i < pair_count; ++i) {
+    offsets[i + 1] += offsets[i];
+  }
+  return offsets;
+}
+
+// Applies the operations of every pair to its strings, which are read as bytes
+template <typename Ops, typename Rows>
+static Rcpp::CharacterVector applyPairs(const Rows& rows, const std::vector<size_t>& offsets,
+                                        const Rcpp::CharacterVector& s1, const Rcpp::CharacterVector& s2) {
+  StringPool pool1(s1, false);
+  StringPool pool2(s2, false);
+  Rcpp::CharacterVector result(pool1.size());
+  Ops ops;
+
+  for (size_t i = 0; i < pool1.size(); ++i) {
+    auto chars1 = pool1.chars<uint8_t>(i);
+    auto chars2 = pool2.chars<uint8_t>(i);
+    rows.read(ops, offsets[i], offsets[i + 1], chars1.size(), chars2.size());
+    if constexpr (std::is_same<Ops, rapidfuzz::Editops>::value) {
+      result[i] = rapidfuzz::editops_apply_str<char>(ops, chars1.begin(), chars1.end(), chars2.begin(), chars2.end());
+    } else {
+      result[i] = rapidfuzz::opcodes_apply_str<char>(ops, chars1.begin(), chars1.end(), chars2.begin(), chars2.end());
+    }
+  }
+  return result;
+}
+
+//' @name editops_apply_batch
+//' @title Apply Edit Operations to Many Strings
+//' @description Applies the edit operations of many pairs of strings, e.g. the result of
+//' \code{batch_editops}, in one call. Every pair is applied in one pass over its strings.
+//' @param editops A data frame of edit operations (pair_id, type, src_pos, dest_pos) with 0-based
+//' positions, sorted by pair_id. Pairs without rows keep their source string.
+//' @param s1 A vector of source strings.
+//' @param s2 A vector of target strings with the same length as s1.
+//' @return A character vector with the transformed string of every pair.
+//' @examples
+//' s1 <- c("kitten", "flaw")
+//' s2 <- c("sitting", "lawn")
+//' editops_apply_batch(batch_editops(s1, s2), s1, s2)
+//' @export
+// [[Rcpp::export]]
+ Rcpp::CharacterVector editops_apply_batch(Rcpp::DataFrame editops,
+                                           Rcpp::CharacterVector s1,
+                                           Rcpp::CharacterVector s2) {
+   if (s1.size() != s2.size()) {
+     Rcpp::stop("s1 and s2 must have the same length.");
+   }
+
+   EditopsRows rows(editops);
+   std::vector<size_t> offsets = pairRowOffsets(editops, static_cast<size_t>(s1.size()));
+   return applyPairs<rapidfuzz::Editops>(rows, offsets, s1, s2);
+ }
+
+//' @name opcodes_apply_batch
+//' @title Apply Opcodes to Many Strings
+//' @description Applies the opcodes of many pairs of strings, e.g. the result of \code{batch_opcodes}, in
+//' one call. Every pair is applied in one pass over its strings.
+//' @param opcodes A data frame of opcodes (pair_id, type, src_begin, src_end, dest_begin, dest_end) with
+//' 0-based, end exclusive ranges, sorted by pair_id. The opcodes of a pair have to cover both strings.
+//' @param s1 A vector of source strings.
+//' @param s2 A vector of target strings with the same length as s1.
+//' @return A character vector with the transformed string of every pair.
+//' @examples
+//' s1 <- c("kitten", "flaw")
+//' s2 <- c("sitting", "lawn")
+//' opcodes_apply_batch(batch_opcodes(s1, s2), s1, s2)
+//' @export
+// [[Rcpp::export]]
+ Rcpp::CharacterVector opcodes_apply_batch(Rcpp::DataFrame opcodes,
+                                           Rcpp::CharacterVector s1,
+                                           Rcpp::CharacterVector s2) {
+   if (s1.size() != s2.size()) {
+     Rcpp::stop("s1 and s2 must have the same length.");
+   }
+
+   OpcodesRows rows(opcodes);
+   std::vector<size_t> offsets = pairRowOffsets(opcodes, static_cast<size_t>(s1.size()));
+   return applyPairs<rapidfuzz::Opcodes>(rows, offsets, s1, s2);
+ }
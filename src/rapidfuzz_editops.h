@@ -0,0 +1,235 @@
+#ifndef RAPIDFUZZ_EDITOPS_H
+#define RAPIDFUZZ_EDITOPS_H
+
+#include <Rcpp.h>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <rapidfuzz/details/types.hpp>
+
+// Names of the edit operation types. The integer code of a type is its 1-based position in this list, so
+// the codes are the values of the factor type columns.
+inline Rcpp::CharacterVector editTypeLevels() {
+  return Rcpp::CharacterVector::create("delete", "insert", "replace");
+}
+
+// Names of the opcode types, which add the blocks of equal characters to the edit operation types
+inline Rcpp::CharacterVector opcodeTypeLevels() {
+  return Rcpp::CharacterVector::create("delete", "insert", "replace", "equal");
+}
+
+inline int editTypeCode(rapidfuzz::EditType type) {
+  switch (type) {
+  case rapidfuzz::EditType::Delete: return 1;
+  case rapidfuzz::EditType::Insert: return 2;
+  case rapidfuzz::EditType::Replace: return 3;
+  default: return NA_INTEGER;
+  }
+}
+
+inline int opcodeTypeCode(rapidfuzz::EditType type) {
+  return type == rapidfuzz::EditType::None ? 4 : editTypeCode(type);
+}
+
+// Type column of edit operations or opcodes from their codes: a factor with the given levels, which stores
+// 4 bytes per operation and is built without creating any string, or the names of the types
+inline SEXP editTypeColumn(const std::vector<int>& codes, bool asFactor,
+                           Rcpp::CharacterVector levels = editTypeLevels()) {
+  if (asFactor) {
+    Rcpp::IntegerVector column(codes.begin(), codes.end());
+    column.attr("levels") = levels;
+    column.attr("class") = "factor";
+    return column;
+  }
+
+  Rcpp::CharacterVector column(codes.size());
+  for (size_t i = 0; i < codes.size(); ++i) {
+    if (codes[i] == NA_INTEGER) column[i] = NA_STRING;
+    else column[i] = levels[codes[i] - 1];
+  }
+  return column;
+}
+
+inline rapidfuzz::EditType parseEditType(const char* name) {
+  if (std::strcmp(name, "delete") == 0) return rapidfuzz::EditType::Delete;
+  if (std::strcmp(name, "insert") == 0) return rapidfuzz::EditType::Insert;
+  if (std::strcmp(name, "replace") == 0) return rapidfuzz::EditType::Replace;
+  if (std::strcmp(name, "equal") == 0) return rapidfuzz::EditType::None;
+  Rcpp::stop("Invalid edit operation type: " + std::string(name));
+}
+
+// Types of a type column created by the editops and opcodes functions, which is a factor or a character
+// vector. The levels of a factor are parsed once, so its rows are only integer lookups.
+inline std::vector<rapidfuzz::EditType> editTypesOf(SEXP column) {
+  if (!Rf_isFactor(column)) {
+    Rcpp::CharacterVector names(column);
+    std::vector<rapidfuzz::EditType> types(static_cast<size_t>(names.size()));
+    for (size_t i = 0; i < types.size(); ++i) {
+      types[i] = parseEditType(CHAR(STRING_ELT(names, static_cast<R_xlen_t>(i))));
+    }
+    return types;
+  }
+
+  Rcpp::IntegerVector codes(column);
+  Rcpp::CharacterVector levels(Rf_getAttrib(column, R_LevelsSymbol));
+  std::vector<rapidfuzz::EditType> levelTypes(static_cast<size_t>(levels.size()));
+  for (size_t i = 0; i < levelTypes.size(); ++i) {
+    levelTypes[i] = parseEditType(CHAR(STRING_ELT(levels, static_cast<R_xlen_t>(i))));
+  }
+
+  std::vector<rapidfuzz::EditType> types(static_cast<size_t>(codes.size()));
+  for (size_t i = 0; i < types.size(); ++i) {
+    if (codes[i] == NA_INTEGER) Rcpp::stop("The type of an edit operation is missing.");
+    types[i] = levelTypes[static_cast<size_t>(codes[i] - 1)];
+  }
+  return types;
+}
+
+// Position column of an operation, which has to be a position in a string of length len
+inline size_t positionOf(const Rcpp::IntegerVector& column, size_t row, size_t len) {
+  int pos = column[row];
+  if (pos == NA_INTEGER || pos < 0 || static_cast<size_t>(pos) > len) {
+    Rcpp::stop("Edit operation " + std::to_string(row + 1) + " is outside of the strings.");
+  }
+  return static_cast<size_t>(pos);
+}
+
+// Column of a data frame of edit operations, which is called name in the results of get_editops and
+// batch_editops and alias in the results of lcs_seq_editops and osa_editops
+inline SEXP editopsColumn(const Rcpp::DataFrame& editops, const char* name, const char* alias) {
+  if (editops.containsElementNamed(name)) return editops[name];
+  if (editops.containsElementNamed(alias)) return editops[alias];
+  Rcpp::stop("The edit operations have no column " + std::string(name) + " or " + std::string(alias) + ".");
+}
+
+// Rows of a data frame created by get_editops, batch_editops, lcs_seq_editops or osa_editops, with 0-based
+// positions
+class EditopsRows {
+public:
+  explicit EditopsRows(const Rcpp::DataFrame& editops)
+    : types(editTypesOf(editopsColumn(editops, "type", "operation"))),
+      src_pos(editopsColumn(editops, "src_pos", "source_position")),
+      dest_pos(editopsColumn(editops, "dest_pos", "destination_position")) {}
+
+  size_t size() const {
+    return types.size();
+  }
+
+  // Edit operations of the rows in [first, last) for strings of the lengths len1 and len2. The rows are
+  // checked to be ordered and inside of the strings, so applying them never leaves the strings.
+  void read(rapidfuzz::Editops& ops, size_t first, size_t last, size_t len1, size_t len2) const {
+    ops.clear();
+    ops.set_src_len(len1);
+    ops.set_dest_len(len2);
+    size_t src_cursor = 0;
+    size_t inserts = 0;
+    size_t deletes = 0;
+
+    for (size_t row = first; row < last; ++row) {
+      rapidfuzz::EditType type = types[row];
+      bool readsSrc = type == rapidfuzz::EditType::Delete || type == rapidfuzz::EditType::Replace;
+      bool readsDest = type == rapidfuzz::EditType::Insert || type == rapidfuzz::EditType::Replace;
+      size_t src = 0;
+      size_t dest = 0;
+
+      // osa_editops gives -1 for the position in the string an operation does not read. Between the
+      // operations both strings advance together, so it follows from the inserts and deletes before it.
+      if (type == rapidfuzz::EditType::Insert && src_pos[row] == -1) {
+        dest = positionOf(dest_pos, row, len2);
+        src = shiftedPosition(dest, deletes, inserts, row, len1);
+      } else if (type == rapidfuzz::EditType::Delete && dest_pos[row] == -1) {
+        src = positionOf(src_pos, row, len1);
+        dest = shiftedPosition(src, inserts, deletes, row, len2);
+      } else {
+        src = positionOf(src_pos, row, len1);
+        dest = positionOf(dest_pos, row, len2);
+      }
+
+      if (type == rapidfuzz::EditType::None || src < src_cursor || (readsSrc && src == len1) ||
+          (readsDest && dest == len2) || (type == rapidfuzz::EditType::Insert && ++inserts > len2)) {
+        Rcpp::stop("Edit operation " + std::to_string(row + 1) + " does not fit the strings.");
+      }
+
+      src_cursor = readsSrc ? src + 1 : src;
+      if (type == rapidfuzz::EditType::Delete) ++deletes;
+      ops.emplace_back(type, src, dest);
+    }
+  }
+
+private:
+  // pos + added - removed, which has to be a position in a string of length len
+  static size_t shiftedPosition(size_t pos, size_t added, size_t removed, size_t row, size_t len) {
+    if (pos + added < removed || pos + added - removed > len) {
+      Rcpp::stop("Edit operation " + std::to_string(row + 1) + " is outside of the strings.");
+    }
+    return pos + added - removed;
+  }
+
+  std::vector<rapidfuzz::EditType> types;
+  Rcpp::IntegerVector src_pos;
+  Rcpp::IntegerVector dest_pos;
+};
+
+// Rows of a data frame created by batch_opcodes, with 0-based, end exclusive ranges
+class OpcodesRows {
+public:
+  explicit OpcodesRows(const Rcpp::DataFrame& opcodes)
+    : types(editTypesOf(opcodes["type"])),
+      src_begin(opcodes["src_begin"]),
+      src_end(opcodes["src_end"]),
+      dest_begin(opcodes["dest_begin"]),
+      dest_end(opcodes["dest_end"]) {}
+
+  size_t size() const {
+    return types.size();
+  }
+
+  // Opcodes of the rows in [first, last) for strings of the lengths len1 and len2. The blocks have to
+  // follow each other and cover both strings.
+  void read(rapidfuzz::Opcodes& ops, size_t first, size_t last, size_t len1, size_t len2) const {
+    ops.clear();
+    ops.set_src_len(len1);
+    ops.set_dest_len(len2);
+    size_t src_cursor = 0;
+    size_t dest_cursor = 0;
+
+    for (size_t row = first; row < last; ++row) {
+      rapidfuzz::Opcode op(types[row], positionOf(src_begin, row, len1), positionOf(src_end, row, len1),
+                           positionOf(dest_begin, row, len2), positionOf(dest_end, row, len2));
+      if (op.src_begin != src_cursor || op.dest_begin != dest_cursor || op.src_end < op.src_begin ||
+          op.dest_end < op.dest_begin) {
+        Rcpp::stop("Opcode " + std::to_string(row + 1) + " does not continue the previous opcode.");
+      }
+
+      src_cursor = op.src_end;
+      dest_cursor = op.dest_end;
+      ops.push_back(op);
+    }
+
+    if (src_cursor != len1 || dest_cursor != len2) {
+      Rcpp::stop("The opcodes do not cover the strings they are applied to.");
+    }
+  }
+
+private:
+  std::vector<rapidfuzz::EditType> types;
+  Rcpp::IntegerVector src_begin;
+  Rcpp::IntegerVector src_end;
+  Rcpp::IntegerVector dest_begin;
+  Rcpp::IntegerVector dest_end;
+};
+
+// Characters of a string as a character vector with one element per byte. Every distinct byte is
+// converted into an R string once.
+inline Rcpp::CharacterVector byteElements(const std::string& s) {
+  Rcpp::CharacterVector output(s.size());
+  SEXP chars[256] = {};
+  for (size_t i = 0; i < s.size(); ++i) {
+    unsigned char c = static_cast<unsigned char>(s[i]);
+    if (!chars[c]) chars[c] = Rf_mkCharLen(&s[i], 1);
+    SET_STRING_ELT(output, static_cast<R_xlen_t>(i), chars[c]);
+  }
+  return output;
+}
+
+#endif
@@ -4,9 +4,18 @@
 #include <optional>
 #include <utility>
 #include <algorithm>
+#include <numeric>
+#include <cstdint>
+#include <limits>
 #include <cctype>
 #include <rapidfuzz/fuzz.hpp>
 #include <unordered_map>
+#include "rapidfuzz_batch.h"
+#include "rapidfuzz_pool.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #ifndef SIZE_MAX
 #define SIZE_MAX static_cast<size_t>(-1)
@@ -165,39 +174,255 @@ std::string processString(const std::string& input, bool processor = true, bool
   return processed;
 }
 
+// Upper bound of the score of a scorer based on the lengths and the L1 distance of the character
+// histograms. PartialRatio has no such bound. The bounds never increase with the length difference.
+static double scoreUpperBound(const std::string& scorer, size_t len1, size_t len2, size_t hist_diff = 0) {
+  using namespace rapidfuzz::fuzz::fuzz_detail;
+
+  if (scorer == "WRatio") return WRatio_upper_bound(len1, len2, hist_diff);
+  if (scorer == "Ratio") return ratio_upper_bound(len1, len2, hist_diff);
+  return 100.0;
+}
+
+// Rejects a choice when an upper bound of its score, based on the length difference and
+// the character histograms, cannot reach min_score (or exceed it, when strict is true).
+// PartialRatio has no such bound, so its choices are always scored. The histogram of the
+// choice is only built when the length bound does not reject it and none is passed in.
+template <typename Chars1, typename Chars2>
+static bool prefilterChoice(const Chars1& query,
+                            const rapidfuzz::detail::CharHistogram& queryHist,
+                            const Chars2& choice,
+                            const rapidfuzz::detail::CharHistogram* choiceHist,
+                            const std::string& scorer,
+                            double min_score,
+                            bool strict,
+                            rapidfuzz::experimental::PrefilterStats& stats) {
+  auto upperBound = [&](size_t hist_diff) {
+    return scoreUpperBound(scorer, query.size(), choice.size(), hist_diff);
+  };
+  auto rejected = [&](double bound) {
+    return strict ? bound <= min_score : bound < min_score;
+  };
+
+  if (rejected(upperBound(0))) {
+    stats.length++;
+    return true;
+  }
+
+  size_t hist_diff = choiceHist
+    ? queryHist.l1_distance(*choiceHist)
+    : queryHist.l1_distance(rapidfuzz::detail::CharHistogram(choice));
+  if (rejected(upperBound(hist_diff))) {
+    stats.histogram++;
+    return true;
+  }
+
+  stats.scored++;
+  return false;
+}
+
+template <typename Chars1, typename Chars2>
+static bool prefilterChoice(const Chars1& query,
+                            const rapidfuzz::detail::CharHistogram& queryHist,
+                            const Chars2& choice,
+                            const std::string& scorer,
+                            double min_score,
+                            bool strict,
+                            rapidfuzz::experimental::PrefilterStats& stats) {
+  return prefilterChoice(query, queryHist, choice, nullptr, scorer, min_score, strict, stats);
+}
+
+// Processed strings of a call in a pool, decoded into code points like the strings of the per-pair
+// functions, so the scores and the lengths seen by the prefilters count characters instead of bytes
+static StringPool processedPool(const std::vector<std::string>& strings, size_t first, size_t last,
+                                bool processor, int num_threads = 1, bool decode = true) {
+  std::vector<std::string> processed(last - first);
+  int threads = std::max(num_threads, 1);
+  (void)threads;
+
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(threads) schedule(static)
+#endif
+  for (size_t i = first; i < last; ++i) {
+    processed[i - first] = processString(strings[i], processor);
+  }
+  return StringPool(processed, decode);
+}
+
+// Strings of an extract function, given as a character vector or a string_pool(). Without a processor the
+// strings of a string_pool() are scored from the pool itself, so they are not decoded again for every call.
+// Otherwise the processed strings are stored in a new pool, decoded like the strings they came from.
+class ExtractStrings {
+public:
+  explicit ExtractStrings(SEXP x) {
+    if (Rf_inherits(x, "rapidfuzz_string_pool")) {
+      given.reset(new StringPoolArg(x));
+      labels = (*given)->source();
+    } else {
+      labels = Rcpp::CharacterVector(x);
+    }
+  }
+
+  size_t size() const {
+    return static_cast<size_t>(labels.size());
+  }
+
+  // Prepares the strings [first, last) for scoring. They are the strings [begin(), end()) of pool().
+  void process(bool processor, size_t first, size_t last, int num_threads = 1) {
+    if (given && !processor) {
+      scored = &**given;
+      range_begin = first;
+      offset = 0;
+    } else {
+      bool decode = given ? (*given)->isDecoded() : true;
+      owned.reset(new StringPool(processedPool(Rcpp::as<std::vector<std::string>>(labels), first, last,
+                                               processor, num_threads, decode)));
+      scored = owned.get();
+      range_begin = 0;
+      offset = first;
+    }
+    range_end = range_begin + (last - first);
+  }
+
+  void process(bool processor, int num_threads = 1) {
+    process(processor, 0, size(), num_threads);
+  }
+
+  const StringPool& pool() const {
+    return *scored;
+  }
+
+  size_t begin() const {
+    return range_begin;
+  }
+
+  size_t end() const {
+    return range_end;
+  }
+
+  // Position in the input of string i of pool()
+  size_t position(size_t i) const {
+    return i + offset;
+  }
+
+  // Unprocessed string i of pool(), as returned by the functions returning the matched strings
+  std::string label(size_t i) const {
+    return Rcpp::as<std::string>(labels[position(i)]);
+  }
+
+private:
+  Rcpp::CharacterVector labels;
+  std::unique_ptr<StringPoolArg> given;
+  std::unique_ptr<StringPool> owned;
+  const StringPool* scored = nullptr;
+  size_t range_begin = 0;
+  size_t range_end = 0;
+  size_t offset = 0;
+};
+
 //' @name extract_similar_strings
 //' @title Extract Matches
 //' @description Compares a query string to all strings in a list of choices and returns all elements
 //' with a similarity score above the score_cutoff.
 //' @param query The query string to compare.
-//' @param choices A vector of strings to compare against the query.
+//' @param choices A vector of strings or a \code{string_pool} to compare against the query. A pool is
+//' scored without converting its strings again when \code{processor} is FALSE.
 //' @param score_cutoff A numeric value specifying the minimum similarity score (default is 50.0).
 //' @param processor A boolean indicating whether to preprocess strings before comparison (default is TRUE).
-//' @return A data frame containing matched strings and their similarity scores.
+//' @return A data frame containing matched strings and their similarity scores. The attribute "prefilter"
+//' counts the choices rejected by the length and character histogram prefilters and the choices that were scored.
 //' @export
 // [[Rcpp::export]]
  Rcpp::DataFrame extract_similar_strings(const std::string& query,
-                                         const std::vector<std::string>& choices,
+                                         SEXP choices,
                                          double score_cutoff = 50.0,
                                          bool processor = true) {
    std::string processedQuery = processString(query, processor);
+   ExtractStrings choiceStrings(choices);
+   choiceStrings.process(processor);
+   const StringPool& pool = choiceStrings.pool();
    std::vector<std::string> matched_choices;
    std::vector<double> scores;
+   rapidfuzz::experimental::PrefilterStats stats;
+
+   visitPoolQuery(pool, processedQuery, [&](auto tag, const auto& queryChars) {
+     using CharT = decltype(tag);
+     rapidfuzz::fuzz::CachedWRatio scorer(queryChars);
+     rapidfuzz::detail::CharHistogram queryHist(queryChars);
 
-   rapidfuzz::fuzz::CachedWRatio<std::string::value_type> scorer(processedQuery);
+     for (size_t i = 0; i < pool.size(); ++i) {
+       auto choiceChars = pool.chars<CharT>(i);
+       if (prefilterChoice(queryChars, queryHist, choiceChars, "WRatio", score_cutoff, false, stats)) {
+         continue;
+       }
 
-   for (const auto& choice : choices) {
-     std::string processedChoice = processString(choice, processor);
-     double score = scorer.similarity(processedChoice, score_cutoff);
+       double score = scorer.similarity(choiceChars, score_cutoff);
 
-     if (score >= score_cutoff) {
-       matched_choices.push_back(choice);
-       scores.push_back(score);
+       if (score >= score_cutoff) {
+         matched_choices.push_back(choiceStrings.label(i));
+         scores.push_back(score);
+       }
      }
-   }
+   });
 
-   return Rcpp::DataFrame::create(Rcpp::Named("choice") = matched_choices,
-                                  Rcpp::Named("score") = scores);
+   Rcpp::DataFrame result = Rcpp::DataFrame::create(Rcpp::Named("choice") = matched_choices,
+                                                    Rcpp::Named("score") = scores);
+   result.attr("prefilter") = prefilterCounts(stats);
+   return result;
+ }
+
+//' @name extract_similar_indices
+//' @title Extract Match Positions
+//' @description Compares a query string to all strings in a list of choices and returns the positions
+//' of all elements with a similarity score above the score_cutoff. Unlike \code{extract_similar_strings},
+//' no strings are copied into the result, so it can be joined back onto the data the choices came from.
+//' @param query The query string to compare.
+//' @param choices A vector of strings or a \code{string_pool} to compare against the query. A pool is
+//' scored without converting its strings again when \code{processor} is FALSE.
+//' @param score_cutoff A numeric value specifying the minimum similarity score (default is 50.0).
+//' @param processor A boolean indicating whether to preprocess strings before comparison (default is TRUE).
+//' @return A data frame with the 1-based position of each match in \code{choices} (integer) and its
+//' similarity score (double), in the order of \code{choices}.
+//' @examples
+//' extract_similar_indices("new york jets", c("Atlanta Falcons", "New York Jets", "New York Giants"))
+//' @export
+// [[Rcpp::export]]
+ Rcpp::DataFrame extract_similar_indices(const std::string& query,
+                                         SEXP choices,
+                                         double score_cutoff = 50.0,
+                                         bool processor = true) {
+   std::string processedQuery = processString(query, processor);
+   ExtractStrings choiceStrings(choices);
+   choiceStrings.process(processor);
+   const StringPool& pool = choiceStrings.pool();
+   std::vector<int> indices;
+   std::vector<double> scores;
+   rapidfuzz::experimental::PrefilterStats stats;
+
+   visitPoolQuery(pool, processedQuery, [&](auto tag, const auto& queryChars) {
+     using CharT = decltype(tag);
+     rapidfuzz::fuzz::CachedWRatio scorer(queryChars);
+     rapidfuzz::detail::CharHistogram queryHist(queryChars);
+
+     for (size_t i = 0; i < pool.size(); ++i) {
+       auto choiceChars = pool.chars<CharT>(i);
+       if (prefilterChoice(queryChars, queryHist, choiceChars, "WRatio", score_cutoff, false, stats)) {
+         continue;
+       }
+
+       double score = scorer.similarity(choiceChars, score_cutoff);
+
+       if (score >= score_cutoff) {
+         indices.push_back(static_cast<int>(i) + 1);
+         scores.push_back(score);
+       }
+     }
+   });
+
+   Rcpp::DataFrame result = Rcpp::DataFrame::create(Rcpp::Named("index") = indices,
+                                                    Rcpp::Named("score") = scores);
+   result.attr("prefilter") = prefilterCounts(stats);
+   return result;
  }
 
 //' @name extract_best_match
@@ -205,95 +430,766 @@ std::string processString(const std::string& input, bool processor = true, bool
 //' @description Compares a query string to all strings in a list of choices and returns the best match
 //' with a similarity score above the score_cutoff.
 //' @param query The query string to compare.
-//' @param choices A vector of strings to compare against the query.
+//' @param choices A vector of strings or a \code{string_pool} to compare against the query. A pool is
+//' scored without converting its strings again when \code{processor} is FALSE.
 //' @param score_cutoff A numeric value specifying the minimum similarity score (default is 50.0).
 //' @param processor A boolean indicating whether to preprocess strings before comparison (default is TRUE).
-//' @return A list containing the best matching string and its similarity score.
+//' @return A list containing the best matching string and its similarity score. The attribute "prefilter"
+//' counts the choices rejected by the length and character histogram prefilters and the choices that were scored.
 //' @export
 // [[Rcpp::export]]
  Rcpp::List extract_best_match(const std::string& query,
-                               const std::vector<std::string>& choices,
+                               SEXP choices,
                                double score_cutoff = 50.0,
                                bool processor = true) {
    std::string processedQuery = processString(query, processor);
+   ExtractStrings choiceStrings(choices);
+   choiceStrings.process(processor);
+   const StringPool& pool = choiceStrings.pool();
    std::string best_choice;
    double best_score = score_cutoff;
+   rapidfuzz::experimental::PrefilterStats stats;
+
+   visitPoolQuery(pool, processedQuery, [&](auto tag, const auto& queryChars) {
+     using CharT = decltype(tag);
+     rapidfuzz::fuzz::CachedWRatio scorer(queryChars);
+     rapidfuzz::detail::CharHistogram queryHist(queryChars);
 
-   rapidfuzz::fuzz::CachedWRatio<std::string::value_type> scorer(processedQuery);
+     for (size_t i = 0; i < pool.size(); ++i) {
+       auto choiceChars = pool.chars<CharT>(i);
+       if (prefilterChoice(queryChars, queryHist, choiceChars, "WRatio", best_score, true, stats)) {
+         continue;
+       }
 
-   for (const auto& choice : choices) {
-     std::string processedChoice = processString(choice, processor);
-     double score = scorer.similarity(processedChoice, best_score);
+       double score = scorer.similarity(choiceChars, best_score);
 
-     if (score > best_score) {
-       best_score = score;
-       best_choice = choice;
+       if (score > best_score) {
+         best_score = score;
+         best_choice = choiceStrings.label(i);
+       }
      }
-   }
+   });
 
-   return Rcpp::List::create(Rcpp::Named("choice") = best_choice,
-                             Rcpp::Named("score") = best_score);
+   Rcpp::List result = Rcpp::List::create(Rcpp::Named("choice") = best_choice,
+                                          Rcpp::Named("score") = best_score);
+   result.attr("prefilter") = prefilterCounts(stats);
+   return result;
  }
 
+// Sorts (index, score) pairs by descending score, breaking ties by the original index, and keeps
+// the first limit entries (all of them when limit <= 0)
+static void sortMatches(std::vector<std::pair<size_t, double>>& results, int limit) {
+  std::sort(results.begin(), results.end(), [](const auto& a, const auto& b) {
+    if (a.second != b.second) return a.second > b.second;// Sort descending by score
+    return a.first < b.first;
+  });
+
+  if (limit > 0 && results.size() > static_cast<size_t>(limit)) {
+    results.resize(limit);// Limit the results
+  }
+}
+
+// Scores the processed choices [first, last) against the processed query and returns the (index, score)
+// pairs of the top matches, sorted by descending score with ties broken by the original index
+static std::vector<std::pair<size_t, double>> findMatches(const std::string& processedQuery,
+                                                          const StringPool& choices,
+                                                          size_t first,
+                                                          size_t last,
+                                                          double score_cutoff,
+                                                          int limit,
+                                                          const std::string& scorer,
+                                                          rapidfuzz::experimental::PrefilterStats& stats) {
+  if (scorer != "WRatio" && scorer != "Ratio" && scorer != "PartialRatio") {
+    Rcpp::stop("Invalid scorer specified.");
+  }
+
+  std::vector<std::pair<size_t, double>> results;
+
+  visitPoolQuery(choices, processedQuery, [&](auto tag, const auto& queryChars) {
+    using CharT = decltype(tag);
+    rapidfuzz::detail::CharHistogram queryHist(queryChars);
+
+    for (size_t i = first; i < last; ++i) {
+      auto choiceChars = choices.chars<CharT>(i);
+      if (prefilterChoice(queryChars, queryHist, choiceChars, scorer, score_cutoff, false, stats)) {
+        continue;
+      }
+
+      double similarity = 0.0;
+
+     // Select scoring method
+      if (scorer == "WRatio") {
+        similarity = static_cast<double>(rapidfuzz::fuzz::WRatio(queryChars, choiceChars));
+      } else if (scorer == "Ratio") {
+        similarity = static_cast<double>(rapidfuzz::fuzz::ratio(queryChars, choiceChars));
+      } else {
+        similarity = static_cast<double>(rapidfuzz::fuzz::partial_ratio(queryChars, choiceChars));
+      }
+
+      if (similarity >= score_cutoff) {
+        results.emplace_back(i, similarity);
+      }
+    }
+  });
+
+  sortMatches(results, limit);
+  return results;
+}
+
 //' @name extract_matches
 //' @title Extract Matches with Scoring and Limit
 //' @description Compares a query string to a list of choices using the specified scorer and returns
 //' the top matches with a similarity score above the cutoff.
 //' @param query The query string to compare.
-//' @param choices A vector of strings to compare against the query.
+//' @param choices A vector of strings or a \code{string_pool} to compare against the query. A pool is
+//' scored without converting its strings again when \code{processor} is FALSE.
 //' @param score_cutoff A numeric value specifying the minimum similarity score (default is 50.0).
 //' @param limit The maximum number of matches to return (default is 3).
 //' @param processor A boolean indicating whether to preprocess strings before comparison (default is TRUE).
 //' @param scorer A string specifying the similarity scoring method ("WRatio", "Ratio", "PartialRatio", etc.).
-//' @return A data frame containing the top matched strings and their similarity scores.
+//' @return A data frame containing the top matched strings and their similarity scores. The attribute
+//' "prefilter" counts the choices rejected by the length and character histogram prefilters and the choices
+//' that were scored.
 //' @export
 // [[Rcpp::export]]
  Rcpp::DataFrame extract_matches(const std::string& query,
-                                 const std::vector<std::string>& choices,
+                                 SEXP choices,
                                  double score_cutoff = 50.0,
                                  int limit = 3,
                                  bool processor = true,
                                  std::string scorer = "WRatio") {
    std::string processedQuery = processString(query, processor);
-   std::vector<std::pair<std::string, double>> results;
-
-   for (const auto& choice : choices) {
-     std::string processedChoice = processString(choice, processor);
-     double similarity = 0.0;
-
-  // Select scoring method
-     if (scorer == "WRatio") {
-       similarity = static_cast<double>(rapidfuzz::fuzz::WRatio(processedQuery, processedChoice));
-     } else if (scorer == "Ratio") {
-       similarity = static_cast<double>(rapidfuzz::fuzz::ratio(processedQuery, processedChoice));
-     } else if (scorer == "PartialRatio") {
-       similarity = static_cast<double>(rapidfuzz::fuzz::partial_ratio(processedQuery, processedChoice));
-     } else {
-       Rcpp::stop("Invalid scorer specified.");
-     }
+   ExtractStrings choiceStrings(choices);
+   choiceStrings.process(processor);
+   const StringPool& pool = choiceStrings.pool();
+   rapidfuzz::experimental::PrefilterStats stats;
+   auto results = findMatches(processedQuery, pool, 0, pool.size(), score_cutoff, limit, scorer, stats);
 
-     if (similarity >= score_cutoff) {
-       results.emplace_back(choice, similarity);
-     }
+   std::vector<std::string> matched_choices;
+   std::vector<double> scores;
+
+   for (const auto& result : results) {
+     matched_choices.push_back(choiceStrings.label(result.first));
+     scores.push_back(result.second);
    }
 
+   Rcpp::DataFrame result = Rcpp::DataFrame::create(Rcpp::Named("choice") = matched_choices,
+                                                    Rcpp::Named("score") = scores);
+   result.attr("prefilter") = prefilterCounts(stats);
+   return result;
+ }
 
-   std::sort(results.begin(), results.end(), [](const auto& a, const auto& b) {
-     return a.second > b.second;// Sort descending by score
-   });
+//' @name extract_matches_indices
+//' @title Extract Top Match Positions
+//' @description Compares a query string to a list of choices using the specified scorer and returns
+//' the positions of the top matches with a similarity score above the cutoff. Unlike
+//' \code{extract_matches}, no strings are copied into the result.
+//' @param query The query string to compare.
+//' @param choices A vector of strings or a \code{string_pool} to compare against the query. A pool is
+//' scored without converting its strings again when \code{processor} is FALSE.
+//' @param score_cutoff A numeric value specifying the minimum similarity score (default is 50.0).
+//' @param limit The maximum number of matches to return (default is 3).
+//' @param processor A boolean indicating whether to preprocess strings before comparison (default is TRUE).
+//' @param scorer A string specifying the similarity scoring method ("WRatio", "Ratio", "PartialRatio", etc.).
+//' @return A data frame with the 1-based position of each match in \code{choices} (integer) and its
+//' similarity score (double), sorted by descending score with ties broken by position.
+//' @examples
+//' extract_matches_indices("new york jets", c("Atlanta Falcons", "New York Jets", "New York Giants"))
+//' @export
+// [[Rcpp::export]]
+ Rcpp::DataFrame extract_matches_indices(const std::string& query,
+                                         SEXP choices,
+                                         double score_cutoff = 50.0,
+                                         int limit = 3,
+                                         bool processor = true,
+                                         std::string scorer = "WRatio") {
+   std::string processedQuery = processString(query, processor);
+   ExtractStrings choiceStrings(choices);
+   choiceStrings.process(processor);
+   const StringPool& pool = choiceStrings.pool();
+   rapidfuzz::experimental::PrefilterStats stats;
+   auto results = findMatches(processedQuery, pool, 0, pool.size(), score_cutoff, limit, scorer, stats);
 
-   if (limit > 0 && results.size() > static_cast<size_t>(limit)) {
-     results.resize(limit);// Limit the results
+   Rcpp::IntegerVector indices(results.size());
+   Rcpp::NumericVector scores(results.size());
+
+   for (size_t i = 0; i < results.size(); ++i) {
+     indices[i] = static_cast<int>(results[i].first) + 1;
+     scores[i] = results[i].second;
    }
 
+   Rcpp::DataFrame result = Rcpp::DataFrame::create(Rcpp::Named("index") = indices,
+                                                    Rcpp::Named("score") = scores);
+   result.attr("prefilter") = prefilterCounts(stats);
+   return result;
+ }
+
+//' @name extract_matches_shard
+//' @title Extract Matches from a Shard of the Choices
+//' @description Computes the \code{extract_matches} result for shard \code{shard} of \code{n_shards} of
+//' the choices. The choices are split into \code{n_shards} contiguous blocks of almost equal size, so every
+//' process working on the same choices vector sees the same partition. The per-shard results can be
+//' combined with \code{merge_matches}.
+//' @param query The query string to compare.
+//' @param choices A vector of strings or a \code{string_pool} to compare against the query. A pool is
+//' scored without converting its strings again when \code{processor} is FALSE.
+//' @param shard The shard to compute, between 1 and \code{n_shards}.
+//' @param n_shards The total number of shards.
+//' @param score_cutoff A numeric value specifying the minimum similarity score (default is 50.0).
+//' @param limit The maximum number of matches to return (default is 3).
+//' @param processor A boolean indicating whether to preprocess strings before comparison (default is TRUE).
+//' @param scorer A string specifying the similarity scoring method ("WRatio", "Ratio", "PartialRatio", etc.).
+//' @return A data frame with the 1-based position of each match in \code{choices}, the matched string
+//' and its similarity score, sorted by descending score with ties broken by position.
+//' @examples
+//' choices <- c("Atlanta Falcons", "New York Jets", "New York Giants", "Dallas Cowboys")
+//' shards <- lapply(1:2, function(i) extract_matches_shard("new york jets", choices, i, 2))
+//' merge_matches(shards)
+//' @export
+// [[Rcpp::export]]
+ Rcpp::DataFrame extract_matches_shard(const std::string& query,
+                                       SEXP choices,
+                                       int shard,
+                                       int n_shards,
+                                       double score_cutoff = 50.0,
+                                       int limit = 3,
+                                       bool processor = true,
+                                       std::string scorer = "WRatio") {
+   if (n_shards < 1 || shard < 1 || shard > n_shards) {
+     Rcpp::stop("shard has to be between 1 and n_shards.");
+   }
+
+   ExtractStrings choiceStrings(choices);
+
+   // Shard i covers [floor((i - 1) * n / n_shards), floor(i * n / n_shards))
+   size_t first = choiceStrings.size() * static_cast<size_t>(shard - 1) / static_cast<size_t>(n_shards);
+   size_t last = choiceStrings.size() * static_cast<size_t>(shard) / static_cast<size_t>(n_shards);
+
+   // only the choices of the shard are processed
+   std::string processedQuery = processString(query, processor);
+   choiceStrings.process(processor, first, last);
+   rapidfuzz::experimental::PrefilterStats stats;
+   auto results = findMatches(processedQuery, choiceStrings.pool(), choiceStrings.begin(), choiceStrings.end(),
+                              score_cutoff, limit, scorer, stats);
+
+   std::vector<int> indices;
    std::vector<std::string> matched_choices;
    std::vector<double> scores;
 
    for (const auto& result : results) {
-     matched_choices.push_back(result.first);
+     indices.push_back(static_cast<int>(choiceStrings.position(result.first)) + 1);
+     matched_choices.push_back(choiceStrings.label(result.first));
      scores.push_back(result.second);
    }
 
-   return Rcpp::DataFrame::create(Rcpp::Named("choice") = matched_choices,
+   Rcpp::DataFrame result = Rcpp::DataFrame::create(Rcpp::Named("index") = indices,
+                                                    Rcpp::Named("choice") = matched_choices,
+                                                    Rcpp::Named("score") = scores);
+   result.attr("prefilter") = prefilterCounts(stats);
+   return result;
+ }
+
+//' @name merge_matches
+//' @title Merge Per-Shard Matches
+//' @description Merges the top matches of several shards, as returned by \code{extract_matches_shard},
+//' into the global top matches. Ties are broken by the original position, so the result does not depend
+//' on the number of shards or the order in which they are passed.
+//' @param results A list of data frames with the columns \code{index}, \code{choice} and \code{score}.
+//' @param limit The maximum number of matches to return (default is 3).
+//' @return A data frame with the columns \code{index}, \code{choice} and \code{score}, sorted by
+//' descending score with ties broken by position.
+//' @examples
+//' choices <- c("Atlanta Falcons", "New York Jets", "New York Giants", "Dallas Cowboys")
+//' shards <- lapply(1:2, function(i) extract_matches_shard("new york jets", choices, i, 2))
+//' merge_matches(shards)
+//' @export
+// [[Rcpp::export]]
+ Rcpp::DataFrame merge_matches(Rcpp::List results, int limit = 3) {
+   struct Match {
+     int index;
+     std::string choice;
+     double score;
+   };
+   std::vector<Match> merged;
+
+   for (R_xlen_t i = 0; i < results.size(); ++i) {
+     Rcpp::DataFrame shard = Rcpp::as<Rcpp::DataFrame>(results[i]);
+     Rcpp::IntegerVector indices = shard["index"];
+     Rcpp::CharacterVector choices = shard["choice"];
+     Rcpp::NumericVector scores = shard["score"];
+
+     for (R_xlen_t j = 0; j < indices.size(); ++j) {
+       merged.push_back({indices[j], Rcpp::as<std::string>(choices[j]), scores[j]});
+     }
+   }
+
+   std::sort(merged.begin(), merged.end(), [](const Match& a, const Match& b) {
+     if (a.score != b.score) return a.score > b.score;// Sort descending by score
+     return a.index < b.index;
+   });
+
+   if (limit > 0 && merged.size() > static_cast<size_t>(limit)) {
+     merged.resize(limit);// Limit the results
+   }
+
+   std::vector<int> indices;
+   std::vector<std::string> matched_choices;
+   std::vector<double> scores;
+
+   for (const auto& match : merged) {
+     indices.push_back(match.index);
+     matched_choices.push_back(match.choice);
+     scores.push_back(match.score);
+   }
+
+   return Rcpp::DataFrame::create(Rcpp::Named("index") = indices,
+                                  Rcpp::Named("choice") = matched_choices,
                                   Rcpp::Named("score") = scores);
  }
+
+// Cached scorer of one query that scores the choice at a position of the pool of processed choices
+template <typename CachedScorer, typename CharT>
+class ChoiceScorer {
+public:
+  template <typename Chars>
+  ChoiceScorer(const StringPool& choices, const Chars& query) : choices(&choices), cached(query) {}
+
+  double similarity(size_t index, double score_cutoff) const {
+    return cached.similarity(choices->chars<CharT>(index), score_cutoff);
+  }
+
+private:
+  const StringPool* choices;
+  CachedScorer cached;
+};
+
+// Calls func with a factory creating the scorer of a query selected by name. The queries are stored in
+// QueryT, which has to hold the characters of the queries and of the choices of type CharT. WRatio
+// preprocesses the token forms of all choices once and scores them with WRatioQuery.
+template <typename QueryT, typename CharT, typename Func>
+static void dispatchChoiceScorer(const std::string& scorer, const StringPool& choices, Func&& func) {
+  using namespace rapidfuzz::experimental;
+
+  if (scorer == "WRatio") {
+    auto views = choices.views<CharT>();
+    BatchWRatio<QueryT> batch(views.begin(), views.end());
+    return func([&](const auto& query) { return std::make_unique<WRatioQuery<QueryT>>(batch, query); });
+  }
+  if (scorer == "Ratio") {
+    return func([&](const auto& query) {
+      return std::make_unique<ChoiceScorer<rapidfuzz::fuzz::CachedRatio<QueryT>, CharT>>(choices, query);
+    });
+  }
+  if (scorer == "PartialRatio") {
+    return func([&](const auto& query) {
+      return std::make_unique<ChoiceScorer<rapidfuzz::fuzz::CachedPartialRatio<QueryT>, CharT>>(choices, query);
+    });
+  }
+
+  Rcpp::stop("Invalid scorer specified.");
+}
+
+// Inserts a match into a list of at most limit matches sorted by descending score. Choices are visited
+// in ascending order, so a match only displaces an entry with a strictly lower score.
+static void insertMatch(std::vector<std::pair<size_t, double>>& matches, size_t index, double score, int limit) {
+  if (limit <= 0) {
+    matches.emplace_back(index, score);
+    return;
+  }
+
+  if (matches.size() == static_cast<size_t>(limit)) {
+    if (score <= matches.back().second) return;
+    matches.pop_back();
+  }
+
+  auto pos = std::upper_bound(matches.begin(), matches.end(), score, [](double value, const auto& match) {
+    return value > match.second;
+  });
+  matches.insert(pos, std::make_pair(index, score));
+}
+
+//' @name extract_matches_batch
+//' @title Extract Matches for Many Queries
+//' @description Compares every query to a list of choices using the specified scorer and returns the top
+//' matches of each query in long format. The choices are preprocessed once and each query builds its cached
+//' scorer once. For WRatio the sorted tokens and token sets of the choices are precomputed as well, and
+//' stages of WRatio whose weighted score cannot beat the current cutoff are skipped. Queries are processed in blocks that are scored against tiles of choices small enough to
+//' stay in the CPU cache, and the work is spread over \code{num_threads} threads when OpenMP is available.
+//' @param queries A vector of query strings or a \code{string_pool}.
+//' @param choices A vector of strings or a \code{string_pool} to compare against the queries. Pools are
+//' scored without converting their strings again when \code{processor} is FALSE.
+//' @param score_cutoff A numeric value specifying the minimum similarity score (default is 50.0).
+//' @param limit The maximum number of matches to return per query (default is 3). Use 0 to return all matches.
+//' @param processor A boolean indicating whether to preprocess strings before comparison (default is TRUE).
+//' @param scorer A string specifying the similarity scoring method ("WRatio", "Ratio" or "PartialRatio").
+//' @param num_threads The number of threads to use (default is 1).
+//' @return A data frame with the columns \code{query_idx} and \code{choice_idx} (1-based positions in
+//' \code{queries} and \code{choices}) and \code{score}. The matches of each query are sorted by descending
+//' score with ties broken by position. The attribute "prefilter" counts the comparisons rejected by the length
+//' and character histogram prefilters and the comparisons that were scored.
+//' @examples
+//' extract_matches_batch(c("new york jets", "dallas"),
+//'                       c("Atlanta Falcons", "New York Jets", "New York Giants", "Dallas Cowboys"))
+//' @export
+// [[Rcpp::export]]
+ Rcpp::DataFrame extract_matches_batch(SEXP queries,
+                                       SEXP choices,
+                                       double score_cutoff = 50.0,
+                                       int limit = 3,
+                                       bool processor = true,
+                                       std::string scorer = "WRatio",
+                                       int num_threads = 1) {
+   using rapidfuzz::detail::CharHistogram;
+   using rapidfuzz::detail::Range;
+   using Matches = std::vector<std::pair<size_t, double>>;
+
+   // queries scored together against a tile of choices, and choices per tile
+   const size_t query_block = 32;
+   const size_t tile_size = 1024;
+
+   int threads = std::max(num_threads, 1);
+   ExtractStrings queryStrings(queries);
+   ExtractStrings choiceStrings(choices);
+   queryStrings.process(processor);
+   choiceStrings.process(processor, threads);
+   const StringPool& queryPool = queryStrings.pool();
+   const StringPool& choicePool = choiceStrings.pool();
+   size_t query_count = queryPool.size();
+   size_t choice_count = choicePool.size();
+
+   // Work is split into query blocks, and into contiguous chunks of the choices when there are
+   // fewer query blocks than threads. Every unit of work writes only its own results.
+   size_t block_count = (query_count + query_block - 1) / query_block;
+   size_t chunk_count = 1;
+   if (block_count > 0 && block_count < static_cast<size_t>(threads)) {
+     chunk_count = std::min((static_cast<size_t>(threads) + block_count - 1) / block_count,
+                            std::max<size_t>(choice_count, 1));
+   }
+   size_t unit_count = block_count * chunk_count;
+
+   std::vector<std::vector<Matches>> unitMatches(unit_count);
+   std::vector<rapidfuzz::experimental::PrefilterStats> unitStats(unit_count);
+
+   visitPools(queryPool, choicePool, [&](auto queryTag, auto choiceTag) {
+     using QueryT = decltype(queryTag);
+     using CharT = decltype(choiceTag);
+
+     std::vector<CharHistogram> choiceHists(choice_count);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(threads) schedule(static)
+#endif
+     for (size_t i = 0; i < choice_count; ++i) {
+       choiceHists[i] = CharHistogram(choicePool.chars<CharT>(i));
+     }
+
+     dispatchChoiceScorer<CommonChar<QueryT, CharT>, CharT>(scorer, choicePool, [&](auto makeScorer) {
+       using Scorer = typename decltype(makeScorer(std::declval<Range<const QueryT*>>()))::element_type;
+
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(threads) schedule(dynamic)
+#endif
+       for (size_t unit = 0; unit < unit_count; ++unit) {
+         size_t block = unit / chunk_count;
+         size_t chunk = unit % chunk_count;
+         size_t query_first = block * query_block;
+         size_t query_last = std::min(query_first + query_block, query_count);
+         size_t choice_first = choice_count * chunk / chunk_count;
+         size_t choice_last = choice_count * (chunk + 1) / chunk_count;
+
+         std::vector<std::unique_ptr<Scorer>> scorers;
+         std::vector<CharHistogram> queryHists;
+         for (size_t q = query_first; q < query_last; ++q) {
+           scorers.push_back(makeScorer(queryPool.chars<QueryT>(q)));
+           queryHists.emplace_back(queryPool.chars<QueryT>(q));
+         }
+
+         auto& matches = unitMatches[unit];
+         auto& stats = unitStats[unit];
+         matches.resize(query_last - query_first);
+
+         for (size_t tile = choice_first; tile < choice_last; tile += tile_size) {
+           size_t tile_last = std::min(tile + tile_size, choice_last);
+
+           for (size_t q = 0; q < scorers.size(); ++q) {
+             auto query = queryPool.chars<QueryT>(query_first + q);
+             auto& queryMatches = matches[q];
+
+             for (size_t c = tile; c < tile_last; ++c) {
+               // once the list is full a choice has to beat its last entry
+               bool full = limit > 0 && queryMatches.size() == static_cast<size_t>(limit);
+               double min_score = full ? std::max(score_cutoff, queryMatches.back().second) : score_cutoff;
+
+               if (prefilterChoice(query, queryHists[q], choicePool.chars<CharT>(c), &choiceHists[c], scorer,
+                                   min_score, full, stats)) {
+                 continue;
+               }
+
+               double score = scorers[q]->similarity(c, min_score);
+               if (score >= score_cutoff && (!full || score > min_score)) {
+                 insertMatch(queryMatches, c, score, limit);
+               }
+             }
+           }
+         }
+       }
+     });
+   });
+
+   std::vector<int> query_idx;
+   std::vector<int> choice_idx;
+   std::vector<double> scores;
+   rapidfuzz::experimental::PrefilterStats stats;
+
+   for (size_t block = 0; block < block_count; ++block) {
+     size_t query_first = block * query_block;
+     size_t query_last = std::min(query_first + query_block, query_count);
+
+     for (size_t q = query_first; q < query_last; ++q) {
+       Matches merged;
+       for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+         const auto& chunkMatches = unitMatches[block * chunk_count + chunk][q - query_first];
+         merged.insert(merged.end(), chunkMatches.begin(), chunkMatches.end());
+       }
+       sortMatches(merged, limit);
+
+       for (const auto& match : merged) {
+         query_idx.push_back(static_cast<int>(q) + 1);
+         choice_idx.push_back(static_cast<int>(match.first) + 1);
+         scores.push_back(match.second);
+       }
+     }
+   }
+
+   for (const auto& unitStat : unitStats) {
+     stats.length += unitStat.length;
+     stats.histogram += unitStat.histogram;
+     stats.scored += unitStat.scored;
+   }
+
+   Rcpp::DataFrame result = Rcpp::DataFrame::create(Rcpp::Named("query_idx") = query_idx,
+                                                    Rcpp::Named("choice_idx") = choice_idx,
+                                                    Rcpp::Named("score") = scores);
+   result.attr("prefilter") = prefilterCounts(stats);
+   return result;
+ }
+
+// Score of a pair of strings that reached the cutoff of extract_similar_pairs
+struct SimilarPair {
+  uint32_t query;
+  uint32_t choice;
+  double score;
+};
+
+//' @name extract_similar_pairs
+//' @title Extract All Similar Pairs
+//' @description Compares every query to every choice and returns only the pairs whose score reaches
+//' \code{score_cutoff}, as a sparse alternative to a full similarity matrix. The choices are sorted by length
+//' once, so every query only visits the choices whose length allows a score above the cutoff. The remaining
+//' pairs pass the character histogram prefilter before they are scored with the cached scorer of the query.
+//' Every thread collects its pairs in its own buffer and the buffers are merged once all queries are scored.
+//' @param queries A vector of query strings or a \code{string_pool}.
+//' @param choices A vector of strings or a \code{string_pool} to compare against the queries. If NULL, the
+//' queries are compared to each other and only the pairs with \code{query_idx < choice_idx} are returned.
+//' Pools are scored without converting their strings again when \code{processor} is FALSE.
+//' @param score_cutoff A numeric value specifying the minimum similarity score (default is 90.0).
+//' @param processor A boolean indicating whether to preprocess strings before comparison (default is TRUE).
+//' @param scorer A string specifying the similarity scoring method ("WRatio", "Ratio" or "PartialRatio").
+//' @param num_threads The number of threads to use (default is 1).
+//' @param format Either "triplet" for a data frame of the pairs or "csc" for the slots of a compressed
+//' sparse column matrix.
+//' @return For "triplet", a data frame with the columns \code{query_idx} and \code{choice_idx} (1-based)
+//' and \code{score}, sorted by query and choice. For "csc", a list with the 0-based row indices \code{i},
+//' the column pointers \code{p}, the scores \code{x} and the dimensions \code{Dim} of a
+//' \code{length(queries)} x \code{length(choices)} matrix, which can be passed to
+//' \code{Matrix::sparseMatrix(i = i, p = p, x = x, dims = Dim, index1 = FALSE)}. Both carry the attribute
+//' "prefilter" with the number of comparisons rejected by the length and character histogram prefilters
+//' and the number of comparisons that were scored.
+//' @examples
+//' extract_similar_pairs(c("new york jets", "new york giants", "dallas cowboys", "new york jets"),
+//'                       score_cutoff = 80)
+//' extract_similar_pairs(c("new york jets", "dallas"),
+//'                       c("Atlanta Falcons", "New York Jets", "Dallas Cowboys"),
+//'                       score_cutoff = 60, format = "csc")
+//' @export
+// [[Rcpp::export]]
+ SEXP extract_similar_pairs(SEXP queries,
+                            SEXP choices = R_NilValue,
+                            double score_cutoff = 90.0,
+                            bool processor = true,
+                            std::string scorer = "Ratio",
+                            int num_threads = 1,
+                            std::string format = "triplet") {
+   using rapidfuzz::detail::CharHistogram;
+   using rapidfuzz::detail::Range;
+
+   if (format != "triplet" && format != "csc") {
+     Rcpp::stop("Invalid format specified: " + format);
+   }
+
+   bool self_join = Rf_isNull(choices);
+   ExtractStrings queryStrings(queries);
+   queryStrings.process(processor);
+   std::unique_ptr<ExtractStrings> choiceStrings;
+   if (!self_join) {
+     choiceStrings.reset(new ExtractStrings(choices));
+     choiceStrings->process(processor);
+   }
+   const StringPool& queryPool = queryStrings.pool();
+   const StringPool& choicePool = self_join ? queryPool : choiceStrings->pool();
+   size_t query_count = queryPool.size();
+   size_t choice_count = choicePool.size();
+
+   size_t buffer_count = 1;
+#ifdef _OPENMP
+   int threads = std::max(num_threads, 1);
+   buffer_count = static_cast<size_t>(threads);
+#endif
+   std::vector<std::vector<SimilarPair>> threadPairs(buffer_count);
+   std::vector<rapidfuzz::experimental::PrefilterStats> threadStats(buffer_count);
+
+   visitPools(queryPool, choicePool, [&](auto queryTag, auto choiceTag) {
+     using QueryT = decltype(queryTag);
+     using CharT = decltype(choiceTag);
+
+     std::vector<CharHistogram> choiceHists(choice_count);
+     for (size_t i = 0; i < choice_count; ++i) {
+       choiceHists[i] = CharHistogram(choicePool.chars<CharT>(i));
+     }
+
+     // choices sorted by length, so the choices a query can reach the cutoff with form one window
+     std::vector<size_t> byLength(choice_count);
+     std::iota(byLength.begin(), byLength.end(), size_t(0));
+     std::stable_sort(byLength.begin(), byLength.end(), [&](size_t a, size_t b) {
+       return choicePool.chars<CharT>(a).size() < choicePool.chars<CharT>(b).size();
+     });
+     std::vector<size_t> sortedLens(choice_count);
+     for (size_t k = 0; k < choice_count; ++k) {
+       sortedLens[k] = choicePool.chars<CharT>(byLength[k]).size();
+     }
+
+     dispatchChoiceScorer<CommonChar<QueryT, CharT>, CharT>(scorer, choicePool, [&](auto makeScorer) {
+#ifdef _OPENMP
+#pragma omp parallel num_threads(threads)
+#endif
+       {
+         size_t slot = 0;
+#ifdef _OPENMP
+         slot = static_cast<size_t>(omp_get_thread_num());
+#endif
+         auto& pairs = threadPairs[slot];
+         auto& stats = threadStats[slot];
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 16)
+#endif
+         for (size_t q = 0; q < query_count; ++q) {
+           auto query = queryPool.chars<QueryT>(q);
+           size_t len1 = query.size();
+
+           // the upper bound grows with len2 up to len1 and shrinks after it
+           auto reachable = [&](size_t len2) { return scoreUpperBound(scorer, len1, len2) >= score_cutoff; };
+           auto mid = std::lower_bound(sortedLens.begin(), sortedLens.end(), len1);
+           auto first = std::partition_point(sortedLens.begin(), mid, [&](size_t len2) { return !reachable(len2); });
+           auto last = std::partition_point(mid, sortedLens.end(), reachable);
+           size_t window_first = static_cast<size_t>(first - sortedLens.begin());
+           size_t window_last = static_cast<size_t>(last - sortedLens.begin());
+
+           // choices outside of the window are counted as rejected by the length prefilter
+           size_t candidates = self_join ? choice_count - q - 1 : choice_count;
+           size_t visited = 0;
+           if (window_first == window_last) {
+             stats.length += candidates;
+             continue;
+           }
+
+           auto cached = makeScorer(query);
+           CharHistogram queryHist(query);
+
+           for (size_t k = window_first; k < window_last; ++k) {
+             size_t c = byLength[k];
+             if (self_join && c <= q) continue;
+
+             visited++;
+             if (prefilterChoice(query, queryHist, choicePool.chars<CharT>(c), &choiceHists[c], scorer,
+                                 score_cutoff, false, stats)) {
+               continue;
+             }
+
+             double score = cached->similarity(c, score_cutoff);
+             if (score >= score_cutoff) {
+               pairs.push_back({static_cast<uint32_t>(q), static_cast<uint32_t>(c), score});
+             }
+           }
+           stats.length += candidates - visited;
+         }
+       }
+     });
+   });
+
+   size_t pair_count = 0;
+   rapidfuzz::experimental::PrefilterStats stats;
+   for (size_t slot = 0; slot < buffer_count; ++slot) {
+     pair_count += threadPairs[slot].size();
+     stats.length += threadStats[slot].length;
+     stats.histogram += threadStats[slot].histogram;
+     stats.scored += threadStats[slot].scored;
+   }
+
+   // both formats store the pairs and the column pointers in R integer vectors
+   if (pair_count > static_cast<size_t>(std::numeric_limits<int>::max())) {
+     Rcpp::stop("More than 2^31 - 1 pairs reach the score_cutoff. Increase score_cutoff.");
+   }
+
+   std::vector<SimilarPair> pairs;
+   pairs.reserve(pair_count);
+   for (auto& buffer : threadPairs) {
+     pairs.insert(pairs.end(), buffer.begin(), buffer.end());
+     std::vector<SimilarPair>().swap(buffer);
+   }
+
+   if (format == "triplet") {
+     std::sort(pairs.begin(), pairs.end(), [](const SimilarPair& a, const SimilarPair& b) {
+       return a.query != b.query ? a.query < b.query : a.choice < b.choice;
+     });
+
+     std::vector<int> query_idx(pair_count);
+     std::vector<int> choice_idx(pair_count);
+     std::vector<double> scores(pair_count);
+     for (size_t k = 0; k < pair_count; ++k) {
+       query_idx[k] = static_cast<int>(pairs[k].query) + 1;
+       choice_idx[k] = static_cast<int>(pairs[k].choice) + 1;
+       scores[k] = pairs[k].score;
+     }
+
+     Rcpp::DataFrame result = Rcpp::DataFrame::create(Rcpp::Named("query_idx") = query_idx,
+                                                      Rcpp::Named("choice_idx") = choice_idx,
+                                                      Rcpp::Named("score") = scores);
+     result.attr("prefilter") = prefilterCounts(stats);
+     return result;
+   }
+
+   std::sort(pairs.begin(), pairs.end(), [](const SimilarPair& a, const SimilarPair& b) {
+     return a.choice != b.choice ? a.choice < b.choice : a.query < b.query;
+   });
+
+   std::vector<int> rows(pair_count);
+   std::vector<int> colPointers(choice_count + 1, 0);
+   std::vector<double> scores(pair_count);
+   for (size_t k = 0; k < pair_count; ++k) {
+     rows[k] = static_cast<int>(pairs[k].query);
+     colPointers[pairs[k].choice + 1]++;
+     scores[k] = pairs[k].score;
+   }
+   for (size_t c = 0; c < choice_count; ++c) {
+     colPointers[c + 1] += colPointers[c];
+   }
+
+   Rcpp::IntegerVector dims = Rcpp::IntegerVector::create(static_cast<int>(query_count),
+                                                          static_cast<int>(choice_count));
+   Rcpp::List result = Rcpp::List::create(Rcpp::Named("i") = rows,
+                                          Rcpp::Named("p") = colPointers,
+                                          Rcpp::Named("x") = scores,
+                                          Rcpp::Named("Dim") = dims);
+   result.attr("prefilter") = prefilterCounts(stats);
+   return result;
+ }
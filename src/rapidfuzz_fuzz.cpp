@@ -1,5 +1,6 @@
 #include <Rcpp.h>
 #include <rapidfuzz/fuzz.hpp>
+#include "rapidfuzz_utf8.h"
 
 #ifndef SIZE_MAX
 #define SIZE_MAX static_cast<size_t>(-1)
@@ -21,7 +22,9 @@ using namespace Rcpp;
 //' @export
 // [[Rcpp::export]]
  double fuzz_ratio(std::string s1, std::string s2, double score_cutoff = 0.0) {
-   return rapidfuzz::fuzz::ratio(s1, s2, score_cutoff);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::fuzz::ratio(chars1, chars2, score_cutoff);
+   });
  }
 
 //' @name fuzz_partial_ratio
@@ -36,7 +39,9 @@ using namespace Rcpp;
 //' @export
 // [[Rcpp::export]]
  double fuzz_partial_ratio(std::string s1, std::string s2, double score_cutoff = 0.0) {
-   return rapidfuzz::fuzz::partial_ratio(s1, s2, score_cutoff);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::fuzz::partial_ratio(chars1, chars2, score_cutoff);
+   });
  }
 
 //' @name fuzz_token_sort_ratio
@@ -51,7 +56,9 @@ using namespace Rcpp;
 //' @export
 // [[Rcpp::export]]
  double fuzz_token_sort_ratio(std::string s1, std::string s2, double score_cutoff = 0.0) {
-   return rapidfuzz::fuzz::token_sort_ratio(s1, s2, score_cutoff);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::fuzz::token_sort_ratio(chars1, chars2, score_cutoff);
+   });
  }
 
 //' @name fuzz_token_set_ratio
@@ -66,7 +73,9 @@ using namespace Rcpp;
 //' @export
 // [[Rcpp::export]]
  double fuzz_token_set_ratio(std::string s1, std::string s2, double score_cutoff = 0.0) {
-   return rapidfuzz::fuzz::token_set_ratio(s1, s2, score_cutoff);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::fuzz::token_set_ratio(chars1, chars2, score_cutoff);
+   });
  }
 
 //' @name fuzz_token_ratio
@@ -81,7 +90,9 @@ using namespace Rcpp;
 //' @export
 // [[Rcpp::export]]
  double fuzz_token_ratio(std::string s1, std::string s2, double score_cutoff = 0.0) {
-   return rapidfuzz::fuzz::token_ratio(s1, s2, score_cutoff);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::fuzz::token_ratio(chars1, chars2, score_cutoff);
+   });
  }
 
 //' @name fuzz_WRatio
@@ -96,7 +107,9 @@ using namespace Rcpp;
 //' @export
 // [[Rcpp::export]]
  double fuzz_WRatio(std::string s1, std::string s2, double score_cutoff = 0.0) {
-   return rapidfuzz::fuzz::WRatio(s1, s2, score_cutoff);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::fuzz::WRatio(chars1, chars2, score_cutoff);
+   });
  }
 
 //' @name fuzz_QRatio
@@ -111,5 +124,7 @@ using namespace Rcpp;
 //' @export
 // [[Rcpp::export]]
  double fuzz_QRatio(std::string s1, std::string s2, double score_cutoff = 0.0) {
-   return rapidfuzz::fuzz::QRatio(s1, s2, score_cutoff);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::fuzz::QRatio(chars1, chars2, score_cutoff);
+   });
  }
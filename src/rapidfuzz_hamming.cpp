@@ -1,5 +1,6 @@
 #include <Rcpp.h>
 #include "rapidfuzz/distance/Hamming.hpp"
+#include "rapidfuzz_utf8.h"
 
 #ifndef SIZE_MAX
 #define SIZE_MAX static_cast<size_t>(-1)
@@ -17,7 +18,9 @@
 //' @export
 // [[Rcpp::export]]
  size_t hamming_distance(std::string s1, std::string s2, bool pad = true) {
-   return rapidfuzz::hamming_distance(s1, s2, pad);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::hamming_distance(chars1, chars2, pad);
+   });
  }
 
 //' @name hamming_similarity
@@ -32,7 +35,9 @@
 //' @export
 // [[Rcpp::export]]
  size_t hamming_similarity(std::string s1, std::string s2, bool pad = true) {
-   return rapidfuzz::hamming_similarity(s1, s2, pad);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::hamming_similarity(chars1, chars2, pad);
+   });
  }
 
 //' @name hamming_normalized_distance
@@ -47,7 +52,9 @@
 //' @export
 // [[Rcpp::export]]
  double hamming_normalized_distance(std::string s1, std::string s2, bool pad = true) {
-   return rapidfuzz::hamming_normalized_distance(s1, s2, pad);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::hamming_normalized_distance(chars1, chars2, pad);
+   });
  }
 
 //' @name hamming_normalized_similarity
@@ -62,5 +69,7 @@
 //' @export
 // [[Rcpp::export]]
  double hamming_normalized_similarity(std::string s1, std::string s2, bool pad = true) {
-   return rapidfuzz::hamming_normalized_similarity(s1, s2, pad);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::hamming_normalized_similarity(chars1, chars2, pad);
+   });
  }
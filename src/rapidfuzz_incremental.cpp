@@ -0,0 +1,137 @@
+#include <Rcpp.h>
+#include <rapidfuzz/distance/Levenshtein.hpp>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace Rcpp;
+
+// Choices and Levenshtein state of a type-ahead matcher, kept alive by an external pointer
+struct IncrementalMatcher {
+  IncrementalMatcher(const std::vector<std::string>& choices_, size_t max_distance)
+    : choices(choices_), levenshtein(choices.begin(), choices.end(), max_distance) {}
+
+  std::vector<std::string> choices;
+  rapidfuzz::experimental::IncrementalLevenshtein<char> levenshtein;
+};
+
+static IncrementalMatcher& getMatcher(SEXP matcher) {
+  if (!Rf_inherits(matcher, "rapidfuzz_incremental_matcher")) {
+    Rcpp::stop("matcher must be created with incremental_matcher().");
+  }
+  XPtr<IncrementalMatcher> ptr(matcher);
+  if (!ptr.get()) {
+    Rcpp::stop("The matcher is no longer valid. Create a new one with incremental_matcher().");
+  }
+  return *ptr;
+}
+
+// Returns the choices within max_distance of the current query ordered by distance and index
+static DataFrame matcherResult(const IncrementalMatcher& matcher) {
+  std::vector<std::pair<size_t, size_t>> matches;
+  matcher.levenshtein.for_each_match([&](size_t i, size_t dist) { matches.emplace_back(dist, i); });
+  std::sort(matches.begin(), matches.end());
+
+  std::vector<int> choice_idx;
+  std::vector<std::string> choice;
+  std::vector<int> distance;
+  for (const auto& match : matches) {
+    choice_idx.push_back(static_cast<int>(match.second) + 1);
+    choice.push_back(matcher.choices[match.second]);
+    distance.push_back(static_cast<int>(match.first));
+  }
+
+  return DataFrame::create(
+    Named("choice_idx") = choice_idx,
+    Named("choice") = choice,
+    Named("distance") = distance
+  );
+}
+
+//' @name incremental_matcher
+//' @title Incremental Matcher
+//' @description Creates a matcher for type-ahead search, which keeps the Levenshtein distance between a
+//' query and every choice while the query is typed. Appending a character with
+//' \code{incremental_matcher_push} only advances the stored state of every remaining choice by one step,
+//' instead of comparing the whole query again. Choices that can not get within \code{max_distance} for any
+//' longer query are dropped, and \code{incremental_matcher_pop} restores the state before the last
+//' characters.
+//' @param choices A vector of strings to match the query against.
+//' @param max_distance Maximum Levenshtein distance of a match. Default is 2.
+//' @return An external pointer to the matcher.
+//' @examples
+//' matcher <- incremental_matcher(c("apple", "apply", "banana"), max_distance = 1)
+//' incremental_matcher_push(matcher, "appl")
+//' incremental_matcher_pop(matcher)
+//' @export
+// [[Rcpp::export]]
+ SEXP incremental_matcher(const std::vector<std::string>& choices, int max_distance = 2) {
+   if (max_distance < 0) {
+     Rcpp::stop("max_distance must be non-negative.");
+   }
+
+   XPtr<IncrementalMatcher> matcher(new IncrementalMatcher(choices, static_cast<size_t>(max_distance)), true);
+   matcher.attr("class") = "rapidfuzz_incremental_matcher";
+   return matcher;
+ }
+
+//' @name incremental_matcher_push
+//' @title Append to the Query of an Incremental Matcher
+//' @description Appends characters to the query of a matcher created with \code{incremental_matcher}.
+//' @param matcher A matcher created with \code{incremental_matcher}.
+//' @param chars The characters to append to the query.
+//' @return A data.frame with the 1-based index (\code{choice_idx}), the \code{choice} and the
+//' \code{distance} of every choice within \code{max_distance} of the query, ordered by distance.
+//' @examples
+//' matcher <- incremental_matcher(c("apple", "apply", "banana"), max_distance = 1)
+//' incremental_matcher_push(matcher, "appl")
+//' @export
+// [[Rcpp::export]]
+ DataFrame incremental_matcher_push(SEXP matcher, std::string chars) {
+   IncrementalMatcher& state = getMatcher(matcher);
+   for (char ch : chars) {
+     state.levenshtein.push_back(ch);
+   }
+   return matcherResult(state);
+ }
+
+//' @name incremental_matcher_pop
+//' @title Remove from the Query of an Incremental Matcher
+//' @description Removes the last characters from the query of a matcher created with
+//' \code{incremental_matcher}, restoring the state before they were appended.
+//' @param matcher A matcher created with \code{incremental_matcher}.
+//' @param n Number of characters to remove. Default is 1.
+//' @return A data.frame with the matches of the shortened query, in the same format as
+//' \code{incremental_matcher_push}.
+//' @examples
+//' matcher <- incremental_matcher(c("apple", "apply", "banana"), max_distance = 1)
+//' incremental_matcher_push(matcher, "apples")
+//' incremental_matcher_pop(matcher, 2)
+//' @export
+// [[Rcpp::export]]
+ DataFrame incremental_matcher_pop(SEXP matcher, int n = 1) {
+   IncrementalMatcher& state = getMatcher(matcher);
+   if (n < 0 || static_cast<size_t>(n) > state.levenshtein.size()) {
+     Rcpp::stop("n must be between 0 and the length of the query.");
+   }
+
+   for (int i = 0; i < n; ++i) {
+     state.levenshtein.pop_back();
+   }
+   return matcherResult(state);
+ }
+
+//' @name incremental_matcher_matches
+//' @title Matches of an Incremental Matcher
+//' @description Returns the matches of the current query of a matcher created with
+//' \code{incremental_matcher}.
+//' @param matcher A matcher created with \code{incremental_matcher}.
+//' @return A data.frame in the same format as \code{incremental_matcher_push}.
+//' @examples
+//' matcher <- incremental_matcher(c("apple", "apply", "banana"), max_distance = 1)
+//' incremental_matcher_matches(matcher)
+//' @export
+// [[Rcpp::export]]
+ DataFrame incremental_matcher_matches(SEXP matcher) {
+   return matcherResult(getMatcher(matcher));
+ }
@@ -1,5 +1,6 @@
 #include <Rcpp.h>
 #include "rapidfuzz/distance/Indel.hpp"
+#include "rapidfuzz_utf8.h"
 
 #ifndef SIZE_MAX
 #define SIZE_MAX static_cast<size_t>(-1)
@@ -18,7 +19,9 @@ using namespace Rcpp;
 //' @export
 // [[Rcpp::export]]
  size_t indel_distance(std::string s1, std::string s2) {
-   return rapidfuzz::indel_distance(s1, s2);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::indel_distance(chars1, chars2);
+   });
  }
 
 //' @name indel_normalized_distance
@@ -32,7 +35,9 @@ using namespace Rcpp;
 //' @export
 // [[Rcpp::export]]
  double indel_normalized_distance(std::string s1, std::string s2) {
-   return rapidfuzz::indel_normalized_distance(s1, s2);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::indel_normalized_distance(chars1, chars2);
+   });
  }
 
 //' @name indel_similarity
@@ -46,7 +51,9 @@ using namespace Rcpp;
 //' @export
 // [[Rcpp::export]]
  size_t indel_similarity(std::string s1, std::string s2) {
-   return rapidfuzz::indel_similarity(s1, s2);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::indel_similarity(chars1, chars2);
+   });
  }
 
 //' @name indel_normalized_similarity
@@ -60,5 +67,7 @@ using namespace Rcpp;
 //' @export
 // [[Rcpp::export]]
  double indel_normalized_similarity(std::string s1, std::string s2) {
-   return rapidfuzz::indel_normalized_similarity(s1, s2);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::indel_normalized_similarity(chars1, chars2);
+   });
  }
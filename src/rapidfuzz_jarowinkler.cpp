@@ -1,5 +1,6 @@
 #include <Rcpp.h>
 #include "rapidfuzz/distance/JaroWinkler.hpp"
+#include "rapidfuzz_utf8.h"
 
 #ifndef SIZE_MAX
 #define SIZE_MAX static_cast<size_t>(-1)
@@ -19,7 +20,9 @@ using namespace Rcpp;
 //' @export
 // [[Rcpp::export]]
  double jaro_winkler_distance(std::string s1, std::string s2, double prefix_weight = 0.1) {
-   return rapidfuzz::jaro_winkler_distance(s1, s2, prefix_weight);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::jaro_winkler_distance(chars1, chars2, prefix_weight);
+   });
  }
 
 //' @name jaro_winkler_similarity
@@ -34,7 +37,9 @@ using namespace Rcpp;
 //' @export
 // [[Rcpp::export]]
  double jaro_winkler_similarity(std::string s1, std::string s2, double prefix_weight = 0.1) {
-   return rapidfuzz::jaro_winkler_similarity(s1, s2, prefix_weight);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::jaro_winkler_similarity(chars1, chars2, prefix_weight);
+   });
  }
 
 //' @name jaro_winkler_normalized_distance
@@ -49,7 +54,9 @@ using namespace Rcpp;
 //' @export
 // [[Rcpp::export]]
  double jaro_winkler_normalized_distance(std::string s1, std::string s2, double prefix_weight = 0.1) {
-   return rapidfuzz::jaro_winkler_normalized_distance(s1, s2, prefix_weight);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::jaro_winkler_normalized_distance(chars1, chars2, prefix_weight);
+   });
  }
 
 //' @name jaro_winkler_normalized_similarity
@@ -64,5 +71,7 @@ using namespace Rcpp;
 //' @export
 // [[Rcpp::export]]
  double jaro_winkler_normalized_similarity(std::string s1, std::string s2, double prefix_weight = 0.1) {
-   return rapidfuzz::jaro_winkler_normalized_similarity(s1, s2, prefix_weight);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::jaro_winkler_normalized_similarity(chars1, chars2, prefix_weight);
+   });
  }
@@ -0,0 +1,373 @@
+#include <Rcpp.h>
+#include <algorithm>
+#include <cstdio>
+#include <exception>
+#include <memory>
+#include <string>
+#include <vector>
+#include "rapidfuzz_batch.h"
+#include "rapidfuzz_pool.h"
+
+// ALTREP vectors need R 3.6 for all methods used here. Older versions of R get the computed matrix.
+#if R_VERSION >= R_Version(3, 6, 0)
+#define RAPIDFUZZ_ALTREP
+// the header uses 'class' as a parameter name
+#define class klass
+extern "C" {
+#include <R_ext/Altrep.h>
+}
+#undef class
+#endif
+
+using namespace Rcpp;
+
+// Scores of one query against the choices, for any character types and metric
+class LazyScorer {
+public:
+  virtual ~LazyScorer() {}
+
+  // Normalized similarities of query q to all choices
+  virtual void scoreRow(size_t q, double* out) const = 0;
+
+  // Normalized similarity of query q to choice c
+  virtual double score(size_t q, size_t c) const = 0;
+};
+
+template <typename QueryT, typename CharT, typename Metric>
+class LazyScorerImpl : public LazyScorer {
+public:
+  LazyScorerImpl(std::shared_ptr<const StringPool> queries_, std::shared_ptr<const StringPool> choices_,
+                 Metric metric_)
+    : queries(std::move(queries_)), choices(std::move(choices_)), metric(metric_),
+      scorer(choices->views<CharT>(), metric_) {}
+
+  void scoreRow(size_t q, double* out) const override {
+    scorer.normalized_similarity(out, choices->size(), queries->chars<QueryT>(q));
+  }
+
+  double score(size_t q, size_t c) const override {
+    return metric.make_cached(choices->chars<CharT>(c)).normalized_similarity(queries->chars<QueryT>(q));
+  }
+
+private:
+  std::shared_ptr<const StringPool> queries;
+  std::shared_ptr<const StringPool> choices;
+  Metric metric;
+  rapidfuzz::experimental::BatchScorer<CharT, Metric> scorer;
+};
+
+// Similarity matrix of queries (rows) and choices (columns) whose rows are scored in blocks of blockRows
+// queries when they are first read. With caching, every block is scored at most once and kept, so the
+// memory grows with the blocks that were read.
+class LazyMatrix {
+public:
+  LazyMatrix(std::unique_ptr<LazyScorer> scorer_, size_t rows_, size_t cols_, size_t blockRows_, bool cache_)
+    : scorer(std::move(scorer_)), rows(rows_), cols(cols_), blockRows(blockRows_), cache(cache_),
+      blocks((rows_ + blockRows_ - 1) / blockRows_) {}
+
+  size_t size() const {
+    return rows * cols;
+  }
+
+  size_t rowCount() const {
+    return rows;
+  }
+
+  size_t colCount() const {
+    return cols;
+  }
+
+  size_t blockSize() const {
+    return blockRows;
+  }
+
+  size_t blockCount() const {
+    return blocks.size();
+  }
+
+  size_t cachedBlocks() const {
+    return cached;
+  }
+
+  double element(size_t i) {
+    size_t q = i % rows;
+    size_t c = i / rows;
+    if (!cache) return scorer->score(q, c);
+
+    size_t b = q / blockRows;
+    return block(b, temp)[(q - b * blockRows) * cols + c];
+  }
+
+  // Copies the elements [start, start + n) of the column major matrix into buf
+  void region(size_t start, size_t n, double* buf) {
+    if (n == 0) return;
+    size_t end = start + n;
+    size_t firstCol = start / rows;
+    size_t lastCol = (end - 1) / rows;
+
+    // without caching, regions spanning few columns are cheaper to score pair by pair than as full rows
+    if (!cache && (lastCol - firstCol + 1) * 8 < cols) {
+      for (size_t i = start; i < end; ++i) {
+        buf[i - start] = scorer->score(i % rows, i / rows);
+      }
+      return;
+    }
+
+    for (size_t b = 0; b < blocks.size(); ++b) {
+      size_t blockFirst = b * blockRows;
+      size_t blockLast = std::min(blockFirst + blockRows, rows);
+      const double* data = nullptr;
+
+      for (size_t c = firstCol; c <= lastCol; ++c) {
+        size_t rowFirst = std::max(blockFirst, c == firstCol ? start % rows : 0);
+        size_t rowLast = std::min(blockLast, c == lastCol ? (end - 1) % rows + 1 : rows);
+        if (rowFirst >= rowLast) continue;
+
+        if (!data) data = block(b, temp);
+        for (size_t q = rowFirst; q < rowLast; ++q) {
+          buf[c * rows + q - start] = data[(q - blockFirst) * cols + c];
+        }
+      }
+    }
+  }
+
+  // Writes the complete column major matrix into out. The cached blocks and the strings are released
+  // afterwards, since the caller keeps the result and no element is scored again.
+  void materialize(double* out) {
+    region(0, size(), out);
+    std::vector<std::vector<double>>(blocks.size()).swap(blocks);
+    std::vector<double>().swap(temp);
+    cached = 0;
+    scorer.reset();
+  }
+
+private:
+  // Scores of the queries of block b in row major order. Without caching, they are scored into buffer.
+  const double* block(size_t b, std::vector<double>& buffer) {
+    if (cache && !blocks[b].empty()) return blocks[b].data();
+
+    std::vector<double>& out = cache ? blocks[b] : buffer;
+    size_t first = b * blockRows;
+    size_t last = std::min(first + blockRows, rows);
+    out.resize((last - first) * cols);
+    for (size_t q = first; q < last; ++q) {
+      scorer->scoreRow(q, out.data() + (q - first) * cols);
+    }
+
+    if (cache) ++cached;
+    return out.data();
+  }
+
+  std::unique_ptr<LazyScorer> scorer;
+  size_t rows;
+  size_t cols;
+  size_t blockRows;
+  bool cache;
+  std::vector<std::vector<double>> blocks;
+  std::vector<double> temp;
+  size_t cached = 0;
+};
+
+#ifdef RAPIDFUZZ_ALTREP
+
+static R_altrep_class_t lazyMatrixClass;
+
+static LazyMatrix* lazyMatrix(SEXP x) {
+  return static_cast<LazyMatrix*>(R_ExternalPtrAddr(R_altrep_data1(x)));
+}
+
+// The methods are called by R outside of the Rcpp wrappers, so C++ exceptions are turned into R errors
+// after the exception was destroyed
+template <typename Func>
+static auto guarded(Func&& func) -> decltype(func()) {
+  char message[512];
+  try {
+    return func();
+  } catch (const std::exception& e) {
+    std::snprintf(message, sizeof(message), "%s", e.what());
+  } catch (...) {
+    std::snprintf(message, sizeof(message), "unknown C++ exception");
+  }
+  Rf_error("%s", message);
+}
+
+static R_xlen_t lazyLength(SEXP x) {
+  return static_cast<R_xlen_t>(lazyMatrix(x)->size());
+}
+
+static Rboolean lazyInspect(SEXP x, int, int, int, void (*)(SEXP, int, int, int)) {
+  LazyMatrix* lazy = lazyMatrix(x);
+  Rprintf("rapidfuzz lazy similarity matrix %lu x %lu, %s, %lu of %lu row blocks cached\n",
+          static_cast<unsigned long>(lazy->rowCount()), static_cast<unsigned long>(lazy->colCount()),
+          R_altrep_data2(x) == R_NilValue ? "not materialized" : "materialized",
+          static_cast<unsigned long>(lazy->cachedBlocks()), static_cast<unsigned long>(lazy->blockCount()));
+  return TRUE;
+}
+
+// Computes the complete matrix once R needs a pointer to its data, e.g. for arithmetic on the whole matrix
+static SEXP lazyMaterialized(SEXP x) {
+  SEXP data = R_altrep_data2(x);
+  if (data != R_NilValue) return data;
+
+  LazyMatrix* lazy = lazyMatrix(x);
+  data = PROTECT(Rf_allocVector(REALSXP, static_cast<R_xlen_t>(lazy->size())));
+  guarded([&] { lazy->materialize(REAL(data)); });
+  R_set_altrep_data2(x, data);
+  UNPROTECT(1);
+  return data;
+}
+
+static void* lazyDataptr(SEXP x, Rboolean) {
+  return REAL(lazyMaterialized(x));
+}
+
+static const void* lazyDataptrOrNull(SEXP x) {
+  SEXP data = R_altrep_data2(x);
+  return data == R_NilValue ? nullptr : REAL(data);
+}
+
+static double lazyElt(SEXP x, R_xlen_t i) {
+  SEXP data = R_altrep_data2(x);
+  if (data != R_NilValue) return REAL(data)[i];
+  return guarded([&] { return lazyMatrix(x)->element(static_cast<size_t>(i)); });
+}
+
+static R_xlen_t lazyGetRegion(SEXP x, R_xlen_t start, R_xlen_t n, double* buf) {
+  R_xlen_t length = lazyLength(x);
+  R_xlen_t count = std::min(n, length - start);
+  if (count <= 0) return 0;
+
+  SEXP data = R_altrep_data2(x);
+  if (data != R_NilValue) {
+    std::copy(REAL(data) + start, REAL(data) + start + count, buf);
+  } else {
+    guarded([&] { lazyMatrix(x)->region(static_cast<size_t>(start), static_cast<size_t>(count), buf); });
+  }
+  return count;
+}
+
+// [[Rcpp::init]]
+void registerLazyMatrix(DllInfo* dll) {
+  lazyMatrixClass = R_make_altreal_class("rapidfuzz_lazy_matrix", "RapidFuzz", dll);
+  R_set_altrep_Length_method(lazyMatrixClass, lazyLength);
+  R_set_altrep_Inspect_method(lazyMatrixClass, lazyInspect);
+  R_set_altvec_Dataptr_method(lazyMatrixClass, lazyDataptr);
+  R_set_altvec_Dataptr_or_null_method(lazyMatrixClass, lazyDataptrOrNull);
+  R_set_altreal_Elt_method(lazyMatrixClass, lazyElt);
+  R_set_altreal_Get_region_method(lazyMatrixClass, lazyGetRegion);
+}
+
+// The state of a lazy matrix, or nullptr for any other object
+static LazyMatrix* lazyMatrixArg(SEXP x) {
+  if (ALTREP(x) && R_altrep_inherits(x, lazyMatrixClass)) return lazyMatrix(x);
+  return nullptr;
+}
+
+static bool isMaterialized(SEXP x) {
+  return R_altrep_data2(x) != R_NilValue;
+}
+
+#else
+
+// [[Rcpp::init]]
+void registerLazyMatrix(DllInfo*) {}
+
+// without ALTREP, lazy_similarity_matrix returns ordinary matrices
+static LazyMatrix* lazyMatrixArg(SEXP) {
+  return nullptr;
+}
+
+static bool isMaterialized(SEXP) {
+  return true;
+}
+
+#endif
+
+//' @name lazy_similarity_matrix
+//' @title Lazily Computed Similarity Matrix
+//' @description Creates the matrix of normalized similarities between every query (row) and every choice
+//' (column) without computing it. The rows are scored in blocks of \code{block_rows} queries with the
+//' batch scorers of \code{batch_normalized_similarity} when one of their elements is first read, e.g.
+//' by \code{x[i, ]} or \code{head(x)}, so exploring a few rows of a huge matrix only scores these rows.
+//' The complete matrix is computed once R needs all of its data at once, e.g. for arithmetic on the
+//' whole matrix or when it is modified. Requires R 3.6 or newer, older versions return the computed
+//' matrix.
+//' @param queries A vector of query strings or a \code{string_pool}.
+//' @param choices A vector of strings or a \code{string_pool} to compare against the queries.
+//' @param metric The metric to use ("levenshtein", "indel", "lcs_seq", "osa", "jaro" or "jaro_winkler").
+//' @param block_rows The number of queries scored together. Default is 64.
+//' @param cache If TRUE (default), the scored blocks are kept, so reading them again does not score them
+//' again. The memory then grows with the blocks that were read. If FALSE, nothing is kept and small
+//' reads are scored pair by pair.
+//' @return A numeric matrix with one row per query and one column per choice.
+//' @examples
+//' x <- lazy_similarity_matrix(c("kitten", "mitten", "fitting"), c("sitting", "kitchen", "mitten"))
+//' x[2, ]
+//' lazy_matrix_info(x)
+//' @export
+// [[Rcpp::export]]
+ SEXP lazy_similarity_matrix(SEXP queries,
+                             SEXP choices,
+                             std::string metric = "levenshtein",
+                             int block_rows = 64,
+                             bool cache = true) {
+   if (block_rows < 1) {
+     Rcpp::stop("block_rows must be at least 1.");
+   }
+
+   StringPoolArg queryArg(queries);
+   StringPoolArg choiceArg(choices);
+   // the matrix can outlive pools created with string_pool(), so it keeps its own copies
+   auto queryPool = std::make_shared<const StringPool>(*queryArg);
+   auto choicePool = std::make_shared<const StringPool>(*choiceArg);
+   size_t rows = queryPool->size();
+   size_t cols = choicePool->size();
+
+   std::unique_ptr<LazyScorer> scorer;
+   visitPools(*queryPool, *choicePool, [&](auto queryTag, auto choiceTag) {
+     using QueryT = decltype(queryTag);
+     using CharT = decltype(choiceTag);
+
+     dispatchMetric(metric, [&](auto m) {
+       scorer.reset(new LazyScorerImpl<QueryT, CharT, decltype(m)>(queryPool, choicePool, m));
+     });
+   });
+
+   XPtr<LazyMatrix> lazy(new LazyMatrix(std::move(scorer), rows, cols, static_cast<size_t>(block_rows), cache), true);
+
+#ifdef RAPIDFUZZ_ALTREP
+   Rcpp::RObject result(R_new_altrep(lazyMatrixClass, lazy, R_NilValue));
+#else
+   Rcpp::NumericVector result(static_cast<R_xlen_t>(lazy->size()));
+   lazy->materialize(result.begin());
+#endif
+   result.attr("dim") = Rcpp::IntegerVector::create(static_cast<int>(rows), static_cast<int>(cols));
+   return result;
+ }
+
+//' @name lazy_matrix_info
+//' @title Lazy Matrix Information
+//' @description Describes how much of a matrix created with \code{lazy_similarity_matrix} was computed.
+//' @param x A matrix created with \code{lazy_similarity_matrix}.
+//' @return A list with the dimensions (\code{rows}, \code{cols}), the number of queries scored together
+//' (\code{block_rows}), the number of blocks (\code{blocks}), the number of blocks kept in the cache
+//' (\code{cached_blocks}) and whether the complete matrix was computed (\code{materialized}).
+//' @examples
+//' x <- lazy_similarity_matrix(c("kitten", "mitten"), c("sitting", "kitchen"), block_rows = 1)
+//' x[1, 1]
+//' lazy_matrix_info(x)
+//' @export
+// [[Rcpp::export]]
+ Rcpp::List lazy_matrix_info(SEXP x) {
+   LazyMatrix* lazy = lazyMatrixArg(x);
+   if (!lazy) {
+     Rcpp::stop("x must be created with lazy_similarity_matrix().");
+   }
+
+   return Rcpp::List::create(Rcpp::Named("rows") = static_cast<double>(lazy->rowCount()),
+                             Rcpp::Named("cols") = static_cast<double>(lazy->colCount()),
+                             Rcpp::Named("block_rows") = static_cast<double>(lazy->blockSize()),
+                             Rcpp::Named("blocks") = static_cast<double>(lazy->blockCount()),
+                             Rcpp::Named("cached_blocks") = static_cast<double>(lazy->cachedBlocks()),
+                             Rcpp::Named("materialized") = isMaterialized(x));
+ }
@@ -1,5 +1,7 @@
 #include <Rcpp.h>
 #include "rapidfuzz/distance/LCSseq.hpp"
+#include "rapidfuzz_editops.h"
+#include "rapidfuzz_utf8.h"
 
 #ifndef SIZE_MAX
 #define SIZE_MAX static_cast<size_t>(-1)
@@ -20,7 +22,9 @@ using namespace Rcpp;
 // [[Rcpp::export]]
  size_t lcs_seq_distance(std::string s1, std::string s2, Rcpp::Nullable<double> score_cutoff = R_NilValue) {
    size_t cutoff_value = score_cutoff.isNull() ? std::numeric_limits<size_t>::max() : Rcpp::as<size_t>(score_cutoff);
-   return rapidfuzz::lcs_seq_distance(s1, s2, cutoff_value);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::lcs_seq_distance(chars1, chars2, cutoff_value);
+   });
  }
 
 
@@ -36,7 +40,9 @@ using namespace Rcpp;
 //' @export
 // [[Rcpp::export]]
  size_t lcs_seq_similarity(std::string s1, std::string s2, size_t score_cutoff = 0) {
-   return rapidfuzz::lcs_seq_similarity(s1, s2, score_cutoff);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::lcs_seq_similarity(chars1, chars2, score_cutoff);
+   });
  }
 
 //' @name lcs_seq_normalized_distance
@@ -51,7 +57,9 @@ using namespace Rcpp;
 //' @export
 // [[Rcpp::export]]
  double lcs_seq_normalized_distance(std::string s1, std::string s2, double score_cutoff = 1.0) {
-   return rapidfuzz::lcs_seq_normalized_distance(s1, s2, score_cutoff);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::lcs_seq_normalized_distance(chars1, chars2, score_cutoff);
+   });
  }
 
 //' @name lcs_seq_normalized_similarity
@@ -66,7 +74,9 @@ using namespace Rcpp;
 //' @export
 // [[Rcpp::export]]
  double lcs_seq_normalized_similarity(std::string s1, std::string s2, double score_cutoff = 0.0) {
-   return rapidfuzz::lcs_seq_normalized_similarity(s1, s2, score_cutoff);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::lcs_seq_normalized_similarity(chars1, chars2, score_cutoff);
+   });
  }
 
 //' @name lcs_seq_editops
@@ -74,25 +84,29 @@ using namespace Rcpp;
 //' @description Calculates the edit operations required to transform one string into another.
 //' @param s1 The first string.
 //' @param s2 The second string.
+//' @param types_as_factor If TRUE, the operation column is a factor with the levels "delete", "insert" and
+//' "replace" instead of a character vector.
 //' @return A data.frame containing the edit operations (substitutions, insertions, and deletions).
 //' @examples
 //' lcs_seq_editops("kitten", "sitting")
 //' @export
 // [[Rcpp::export]]
- DataFrame lcs_seq_editops(std::string s1, std::string s2) {
+ DataFrame lcs_seq_editops(std::string s1, std::string s2, bool types_as_factor = false) {
    auto ops = rapidfuzz::lcs_seq_editops(s1, s2);
-   std::vector<std::string> op_types;
+   std::vector<int> op_types;
    std::vector<int> src_pos;
    std::vector<int> dest_pos;
+   op_types.reserve(ops.size());
+   src_pos.reserve(ops.size());
+   dest_pos.reserve(ops.size());
 
    for (const auto& op : ops) {
-     op_types.push_back(op.type == rapidfuzz::EditType::Delete ? "delete" :
-                          op.type == rapidfuzz::EditType::Insert ? "insert" : "replace");
+     op_types.push_back(editTypeCode(op.type));
      src_pos.push_back(op.src_pos);
      dest_pos.push_back(op.dest_pos);
    }
 
-   return DataFrame::create(Named("operation") = op_types,
+   return DataFrame::create(Named("operation") = editTypeColumn(op_types, types_as_factor),
                             Named("source_position") = src_pos,
                             Named("destination_position") = dest_pos);
  }
@@ -1,5 +1,9 @@
 #include <Rcpp.h>
 #include "rapidfuzz/distance/Levenshtein.hpp"
+#include <fstream>
+#include <string>
+#include <vector>
+#include "rapidfuzz_utf8.h"
 
 #ifndef SIZE_MAX
 #define SIZE_MAX static_cast<size_t>(-1)
@@ -21,7 +25,9 @@ using namespace Rcpp;
 //' @export
 // [[Rcpp::export]]
  size_t levenshtein_distance(std::string s1, std::string s2) {
-   return rapidfuzz::levenshtein_distance(s1, s2);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::levenshtein_distance(chars1, chars2);
+   });
  }
 
 //' @name levenshtein_normalized_distance
@@ -38,7 +44,9 @@ using namespace Rcpp;
 //' @export
 // [[Rcpp::export]]
  double levenshtein_normalized_distance(std::string s1, std::string s2) {
-   return rapidfuzz::levenshtein_normalized_distance(s1, s2);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::levenshtein_normalized_distance(chars1, chars2);
+   });
  }
 
 //' @name levenshtein_similarity
@@ -55,7 +63,9 @@ using namespace Rcpp;
 //' @export
 // [[Rcpp::export]]
  size_t levenshtein_similarity(std::string s1, std::string s2) {
-   return rapidfuzz::levenshtein_similarity(s1, s2);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::levenshtein_similarity(chars1, chars2);
+   });
  }
 
 //' @name levenshtein_normalized_similarity
@@ -72,5 +82,128 @@ using namespace Rcpp;
 //' @export
 // [[Rcpp::export]]
  double levenshtein_normalized_similarity(std::string s1, std::string s2) {
-   return rapidfuzz::levenshtein_normalized_similarity(s1, s2);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::levenshtein_normalized_similarity(chars1, chars2);
+   });
+ }
+
+// Collects the matches of an approximate substring search. Positions are stored as double,
+// since texts searched in chunks can be larger than the range of an R integer
+struct SearchMatches {
+  std::vector<int> text;
+  std::vector<double> start;
+  std::vector<double> end;
+  std::vector<int> distance;
+
+  template <typename InputIt>
+  void feed(rapidfuzz::experimental::LevenshteinSearch<char>& search, InputIt first, InputIt last,
+            int text_index, bool return_start) {
+    search.feed(first, last, [&](size_t match_end, size_t dist) {
+      if (return_start) {
+        start.push_back(static_cast<double>(search.match_start(match_end, dist)) + 1);
+      }
+      text.push_back(text_index);
+      end.push_back(static_cast<double>(match_end));
+      distance.push_back(static_cast<int>(dist));
+    });
+  }
+
+  DataFrame result(bool return_start) const {
+    if (return_start) {
+      return DataFrame::create(Named("text") = text, Named("start") = start, Named("end") = end,
+                               Named("distance") = distance);
+    }
+    return DataFrame::create(Named("text") = text, Named("end") = end, Named("distance") = distance);
+  }
+};
+
+static rapidfuzz::experimental::LevenshteinSearch<char> makeSearch(const std::string& pattern, int max_distance) {
+  if (pattern.empty()) {
+    Rcpp::stop("pattern must not be empty.");
+  }
+  if (max_distance < 0) {
+    Rcpp::stop("max_distance must be non-negative.");
+  }
+  return rapidfuzz::experimental::LevenshteinSearch<char>(pattern, static_cast<size_t>(max_distance));
+}
+
+//' @name levenshtein_search
+//' @title Approximate Substring Search
+//' @description
+//' Finds all occurrences of a pattern in a text with at most \code{max_distance} insertions, deletions
+//' and substitutions. In contrast to \code{fuzz_partial_ratio}, which only finds the best matching
+//' window, every end position with a match is reported. The text is scanned once with a bit-parallel
+//' algorithm and the memory usage only depends on the pattern length.
+//'
+//' @param pattern The pattern to search for.
+//' @param text A vector of strings to search in. Each string is searched separately.
+//' @param max_distance Maximum Levenshtein distance of a match. Default is 0.
+//' @param return_start If TRUE, the start of the longest match with this distance is returned as well.
+//' Default is FALSE.
+//' @return A data.frame with one row per match end. \code{text} is the index of the string, \code{start}
+//' (only when \code{return_start} is TRUE) and \code{end} the 1-based byte positions of the match and
+//' \code{distance} its Levenshtein distance to the pattern.
+//' @examples
+//' levenshtein_search("needle", "a haystack with a neddle and a needle", max_distance = 1)
+//' @export
+// [[Rcpp::export]]
+ DataFrame levenshtein_search(std::string pattern, const std::vector<std::string>& text,
+                              int max_distance = 0, bool return_start = false) {
+   auto search = makeSearch(pattern, max_distance);
+   SearchMatches matches;
+
+   for (size_t i = 0; i < text.size(); ++i) {
+     search.reset();
+     matches.feed(search, text[i].begin(), text[i].end(), static_cast<int>(i) + 1, return_start);
+   }
+
+   return matches.result(return_start);
+ }
+
+//' @name levenshtein_search_file
+//' @title Approximate Substring Search in a File
+//' @description
+//' Finds all occurrences of a pattern in a file with at most \code{max_distance} insertions, deletions
+//' and substitutions. The file is read in chunks, so files larger than the available memory can be
+//' searched.
+//'
+//' @param pattern The pattern to search for.
+//' @param path Path of the file to search in.
+//' @param max_distance Maximum Levenshtein distance of a match. Default is 0.
+//' @param return_start If TRUE, the start of the longest match with this distance is returned as well.
+//' Default is FALSE.
+//' @param chunk_size Number of bytes read at once. Default is 1048576.
+//' @return A data.frame with the same columns as \code{levenshtein_search}, where \code{text} is always 1
+//' and the positions are byte offsets in the file.
+//' @examples
+//' path <- tempfile()
+//' writeLines(c("first line with a needle", "second line with a neddle"), path)
+//' levenshtein_search_file("needle", path, max_distance = 1, return_start = TRUE)
+//' @export
+// [[Rcpp::export]]
+ DataFrame levenshtein_search_file(std::string pattern, std::string path, int max_distance = 0,
+                                   bool return_start = false, int chunk_size = 1048576) {
+   if (chunk_size <= 0) {
+     Rcpp::stop("chunk_size must be positive.");
+   }
+
+   std::ifstream file(path, std::ios::binary);
+   if (!file) {
+     Rcpp::stop("Unable to open file: " + path);
+   }
+
+   auto search = makeSearch(pattern, max_distance);
+   SearchMatches matches;
+   std::vector<char> buffer(static_cast<size_t>(chunk_size));
+
+   while (file) {
+     file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+     std::streamsize len = file.gcount();
+     if (len <= 0) break;
+
+     matches.feed(search, buffer.begin(), buffer.begin() + len, 1, return_start);
+     Rcpp::checkUserInterrupt();
+   }
+
+   return matches.result(return_start);
  }
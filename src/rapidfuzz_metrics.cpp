@@ -0,0 +1,107 @@
+#include <Rcpp.h>
+#include <rapidfuzz/metrics.hpp>
+#include "rapidfuzz_pool.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace Rcpp;
+
+// Maps the metric names used by the R functions to the metrics of PairMetrics
+static rapidfuzz::experimental::PairMetric parsePairMetric(const std::string& metric) {
+  using rapidfuzz::experimental::PairMetric;
+
+  if (metric == "levenshtein") return PairMetric::Levenshtein;
+  if (metric == "indel") return PairMetric::Indel;
+  if (metric == "lcs_seq") return PairMetric::LCSseq;
+  if (metric == "osa") return PairMetric::OSA;
+  if (metric == "damerau_levenshtein") return PairMetric::DamerauLevenshtein;
+  if (metric == "jaro") return PairMetric::Jaro;
+  if (metric == "jaro_winkler") return PairMetric::JaroWinkler;
+  Rcpp::stop("Invalid metric specified: " + metric);
+}
+
+//' @name pair_metrics
+//' @title Multiple Metrics for Pairs of Strings
+//' @description Calculates several metrics for every pair of strings in one pass, e.g. to build the
+//' feature vectors of record linkage models. The common prefix and suffix of a pair is removed once and
+//' the bit-parallel pattern of the remaining shorter string is shared by Levenshtein, Indel, LCSseq and
+//' OSA, while Jaro-Winkler reuses the Jaro similarity. The patterns of strings longer than 64 characters
+//' are stored in memory that each thread reuses for all of its pairs.
+//' @param s1 A vector of strings or a \code{string_pool}.
+//' @param s2 A vector of strings or a \code{string_pool} with the same length as s1.
+//' @param metrics The metrics to calculate ("levenshtein", "indel", "lcs_seq", "osa",
+//' "damerau_levenshtein", "jaro" or "jaro_winkler").
+//' @param normalized If TRUE, normalized similarities between 0 and 1 are returned for all metrics.
+//' Otherwise the edit based metrics return distances. Default is FALSE.
+//' @param prefix_weight The prefix weight used by "jaro_winkler". Default is 0.1.
+//' @param num_threads The number of threads to use (default is 1).
+//' @return A numeric matrix with one row per pair and one column per metric.
+//' @examples
+//' pair_metrics(c("kitten", "flaw"), c("sitting", "lawn"),
+//'              metrics = c("levenshtein", "osa", "jaro_winkler"))
+//' @export
+// [[Rcpp::export]]
+ Rcpp::NumericMatrix pair_metrics(SEXP s1,
+                                  SEXP s2,
+                                  Rcpp::CharacterVector metrics = Rcpp::CharacterVector::create("levenshtein", "indel", "lcs_seq", "osa", "jaro_winkler"),
+                                  bool normalized = false,
+                                  double prefix_weight = 0.1,
+                                  int num_threads = 1) {
+   StringPoolArg pool1(s1);
+   StringPoolArg pool2(s2);
+   if (pool1->size() != pool2->size()) {
+     Rcpp::stop("s1 and s2 must have the same length.");
+   }
+
+   std::vector<std::string> metricNames = Rcpp::as<std::vector<std::string>>(metrics);
+   std::vector<rapidfuzz::experimental::PairMetric> pairMetrics;
+   for (const auto& metric : metricNames) {
+     pairMetrics.push_back(parsePairMetric(metric));
+   }
+
+   rapidfuzz::experimental::PairMetrics scorer(pairMetrics, prefix_weight);
+   size_t pair_count = pool1->size();
+   size_t metric_count = scorer.size();
+   Rcpp::NumericMatrix result(static_cast<int>(pair_count), static_cast<int>(metric_count));
+   result.attr("dimnames") = Rcpp::List::create(R_NilValue, metricNames);
+   if (pair_count == 0 || metric_count == 0) {
+     return result;
+   }
+
+   // the matrix is column major, so the scores of a pair are scattered into the columns
+   double* data = &result[0];
+
+#ifdef _OPENMP
+   int threads = std::max(num_threads, 1);
+#endif
+
+   visitPools(*pool1, *pool2, [&](auto tag1, auto tag2) {
+     using CharT1 = decltype(tag1);
+     using CharT2 = decltype(tag2);
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(threads)
+#endif
+     {
+       std::vector<double> scores(metric_count);
+       rapidfuzz::experimental::PairMetrics::Workspace workspace;
+
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+       for (size_t i = 0; i < pair_count; ++i) {
+         scorer.scores(scores.data(), pool1->chars<CharT1>(i), pool2->chars<CharT2>(i), workspace, normalized);
+         for (size_t m = 0; m < metric_count; ++m) {
+           data[m * pair_count + i] = scores[m];
+         }
+       }
+     }
+   });
+
+   return result;
+ }
@@ -5,6 +5,8 @@
 #include <rapidfuzz/details/common.hpp>
 #include <rapidfuzz/distance/OSA_impl.hpp>
 #include <rapidfuzz/distance/LCSseq_impl.hpp>
+#include "rapidfuzz_editops.h"
+#include "rapidfuzz_utf8.h"
 
 #ifndef SIZE_MAX
 #define SIZE_MAX static_cast<size_t>(-1)
@@ -25,7 +27,9 @@ using namespace Rcpp;
 // [[Rcpp::export]]
  double osa_normalized_similarity(std::string s1, std::string s2, double score_cutoff = 0.0) {
    double score_hint = 1.0;
-   return rapidfuzz::detail::OSA::normalized_similarity(s1, s2, score_cutoff, score_hint);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::detail::OSA::normalized_similarity(chars1, chars2, score_cutoff, score_hint);
+   });
  }
 
 //' @name osa_editops
@@ -33,6 +37,8 @@ using namespace Rcpp;
 //' @description Provides the edit operations required to transform one string into another using the OSA algorithm.
 //' @param s1 A string to transform.
 //' @param s2 A target string.
+//' @param types_as_factor If TRUE, the operation column is a factor with the levels "delete", "insert" and
+//' "replace" instead of a character vector.
 //' @return A data frame with the following columns:
 //' \describe{
 //'   \item{operation}{The type of operation (delete, insert, replace).}
@@ -43,29 +49,29 @@ using namespace Rcpp;
 //' osa_editops("string1", "string2")
 //' @export
 // [[Rcpp::export]]
- DataFrame osa_editops(std::string s1, std::string s2) {
+ DataFrame osa_editops(std::string s1, std::string s2, bool types_as_factor = false) {
    auto ops = rapidfuzz::detail::lcs_seq_editops(
      rapidfuzz::detail::Range(s1), rapidfuzz::detail::Range(s2)
    );
 
-   std::vector<std::string> operation_types;
+   std::vector<int> operation_types;
    std::vector<int> source_positions;
    std::vector<int> destination_positions;
 
    for (const auto& op : ops) {
      switch (op.type) {
      case rapidfuzz::EditType::Delete:
-       operation_types.push_back("delete");
+       operation_types.push_back(editTypeCode(op.type));
        source_positions.push_back(op.src_pos);
        destination_positions.push_back(-1);
        break;
      case rapidfuzz::EditType::Insert:
-       operation_types.push_back("insert");
+       operation_types.push_back(editTypeCode(op.type));
        source_positions.push_back(-1);
        destination_positions.push_back(op.dest_pos);
        break;
      case rapidfuzz::EditType::Replace:
-       operation_types.push_back("replace");
+       operation_types.push_back(editTypeCode(op.type));
        source_positions.push_back(op.src_pos);
        destination_positions.push_back(op.dest_pos);
        break;
@@ -77,7 +83,7 @@ using namespace Rcpp;
    }
 
    return DataFrame::create(
-     Named("operation") = operation_types,
+     Named("operation") = editTypeColumn(operation_types, types_as_factor),
      Named("source_position") = source_positions,
      Named("destination_position") = destination_positions
    );
@@ -97,7 +103,9 @@ using namespace Rcpp;
  size_t osa_distance(std::string s1, std::string s2, Rcpp::Nullable<double> score_cutoff = R_NilValue) {
    size_t cutoff_value = score_cutoff.isNull() ? std::numeric_limits<size_t>::max() : Rcpp::as<size_t>(score_cutoff);
    size_t score_hint = std::numeric_limits<size_t>::max();
-   return rapidfuzz::detail::OSA::distance(s1, s2, cutoff_value, score_hint);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::detail::OSA::distance(chars1, chars2, cutoff_value, score_hint);
+   });
  }
 
 //' @name osa_similarity
@@ -113,7 +121,9 @@ using namespace Rcpp;
 // [[Rcpp::export]]
  size_t osa_similarity(std::string s1, std::string s2, size_t score_cutoff = 0) {
    size_t score_hint = 0;
-   return rapidfuzz::detail::OSA::similarity(s1, s2, score_cutoff, score_hint);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::detail::OSA::similarity(chars1, chars2, score_cutoff, score_hint);
+   });
  }
 
 //' @name osa_normalized_distance
@@ -129,5 +139,7 @@ using namespace Rcpp;
 // [[Rcpp::export]]
  double osa_normalized_distance(std::string s1, std::string s2, double score_cutoff = 1.0) {
    double score_hint = 1.0;
-   return rapidfuzz::detail::OSA::normalized_distance(s1, s2, score_cutoff, score_hint);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::detail::OSA::normalized_distance(chars1, chars2, score_cutoff, score_hint);
+   });
  }
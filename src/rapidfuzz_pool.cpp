@@ -0,0 +1,53 @@
+#include <Rcpp.h>
+#include "rapidfuzz_pool.h"
+
+using namespace Rcpp;
+
+//' @name string_pool
+//' @title String Pool
+//' @description Stores a vector of strings in one contiguous buffer together with the offset of every string,
+//' so it can be scored many times without converting the strings again. The strings are decoded from UTF-8
+//' into 8, 16 or 32 bit characters, depending on the largest character of all strings, in a single pass. The
+//' pool can be passed instead of a character vector to \code{batch_distance}, \code{batch_normalized_similarity},
+//' \code{batch_fixed_point_similarity}, \code{batch_token_ratio}, \code{batch_dist}, \code{pair_metrics} and
+//' \code{lazy_similarity_matrix}, which otherwise build a temporary pool for every call. The \code{extract_*}
+//' functions accept a pool as well and score it directly when \code{processor} is FALSE. With a processor they
+//' process the strings the pool was built from, so the pool only saves the conversion without a processor.
+//' @param strings A vector of strings.
+//' @param decode If TRUE (default), the metrics count characters. If FALSE, the strings are stored and
+//' compared as bytes. Pools compared with each other must use the same setting.
+//' @return An external pointer of class \code{rapidfuzz_string_pool}.
+//' @examples
+//' pool <- string_pool(c("kitten", "sitting", "mitten"))
+//' batch_distance("kitchen", pool)
+//' batch_dist(pool, format = "matrix")
+//' @export
+// [[Rcpp::export]]
+ SEXP string_pool(Rcpp::CharacterVector strings, bool decode = true) {
+   XPtr<StringPool> pool(new StringPool(strings, decode), true);
+   pool.attr("class") = "rapidfuzz_string_pool";
+   return pool;
+ }
+
+//' @name string_pool_info
+//' @title String Pool Information
+//' @description Describes the storage of a pool created with \code{string_pool}.
+//' @param pool A pool created with \code{string_pool}.
+//' @return A list with the number of strings (\code{length}), the number of stored characters
+//' (\code{chars}), the bytes per character (\code{char_width}) and whether the strings were decoded from
+//' UTF-8 (\code{decoded}).
+//' @examples
+//' string_pool_info(string_pool(c("kitten", "sitting")))
+//' @export
+// [[Rcpp::export]]
+ Rcpp::List string_pool_info(SEXP pool) {
+   if (!Rf_inherits(pool, "rapidfuzz_string_pool")) {
+     Rcpp::stop("pool must be created with string_pool().");
+   }
+   StringPoolArg arg(pool);
+
+   return Rcpp::List::create(Rcpp::Named("length") = static_cast<double>(arg->size()),
+                             Rcpp::Named("chars") = static_cast<double>(arg->charCount()),
+                             Rcpp::Named("char_width") = static_cast<int>(arg->charWidth()),
+                             Rcpp::Named("decoded") = arg->isDecoded());
+ }
@@ -0,0 +1,189 @@
+#ifndef RAPIDFUZZ_POOL_H
+#define RAPIDFUZZ_POOL_H
+
+#include <Rcpp.h>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <rapidfuzz/details/Range.hpp>
+#include "rapidfuzz_utf8.h"
+
+// Strings stored back to back in one buffer, where string i spans offsets[i] to offsets[i + 1]. The
+// characters are decoded from UTF-8 into the narrowest type holding all of them, or kept as bytes, so the
+// scoring loops read contiguous memory instead of one heap allocation per string. The R strings are kept
+// for the functions returning them as labels.
+class StringPool {
+public:
+  // Built in one pass over the strings. The buffer is widened when a string needs a wider type than the
+  // strings before it, which happens at most twice.
+  explicit StringPool(Rcpp::CharacterVector strings_, bool decode = true)
+    : strings(strings_), decoded(decode) {
+    R_xlen_t count = strings.size();
+    offsets.reserve(static_cast<size_t>(count) + 1);
+    offsets.push_back(0);
+
+    for (R_xlen_t i = 0; i < count; ++i) {
+      SEXP elt = STRING_ELT(strings, i);
+      append(CHAR(elt), static_cast<size_t>(LENGTH(elt)));
+    }
+  }
+
+  // Pool of strings created in C++, e.g. the processed strings of the extract functions. It keeps no R
+  // strings, so its source() is empty.
+  explicit StringPool(const std::vector<std::string>& strings_, bool decode = true) : decoded(decode) {
+    offsets.reserve(strings_.size() + 1);
+    offsets.push_back(0);
+
+    for (const auto& s : strings_) {
+      append(s.data(), s.size());
+    }
+  }
+
+  size_t size() const {
+    return offsets.size() - 1;
+  }
+
+  // Bytes per character: 1, 2 or 4
+  size_t charWidth() const {
+    return width;
+  }
+
+  bool isDecoded() const {
+    return decoded;
+  }
+
+  size_t charCount() const {
+    return width == 1 ? chars8.size() : (width == 2 ? chars16.size() : chars32.size());
+  }
+
+  const Rcpp::CharacterVector& source() const {
+    return strings;
+  }
+
+  // Characters of string i, for the character type of the pool
+  template <typename CharT>
+  rapidfuzz::detail::Range<const CharT*> chars(size_t i) const {
+    const CharT* data = buffer<CharT>().data();
+    return rapidfuzz::detail::Range<const CharT*>(data + offsets[i], data + offsets[i + 1]);
+  }
+
+  // Characters of all strings, e.g. for the constructors of the batch scorers
+  template <typename CharT>
+  std::vector<rapidfuzz::detail::Range<const CharT*>> views() const {
+    std::vector<rapidfuzz::detail::Range<const CharT*>> result;
+    result.reserve(size());
+    for (size_t i = 0; i < size(); ++i) {
+      result.push_back(chars<CharT>(i));
+    }
+    return result;
+  }
+
+  // Calls func with a value of the character type of the pool
+  template <typename Func>
+  auto visit(Func&& func) const {
+    return dispatchCharWidth(width, func);
+  }
+
+private:
+  void append(const char* data, size_t len) {
+    Utf8Info info = decoded ? utf8Info(data, len) : Utf8Info();
+    if (info.width > width) widen(info.width);
+
+    if (width == 1) appendUtf8(data, len, info, chars8);
+    else if (width == 2) appendUtf8(data, len, info, chars16);
+    else appendUtf8(data, len, info, chars32);
+    offsets.push_back(charCount());
+  }
+
+  template <typename CharT>
+  const std::vector<CharT>& buffer() const {
+    if constexpr (std::is_same<CharT, uint8_t>::value) return chars8;
+    else if constexpr (std::is_same<CharT, uint16_t>::value) return chars16;
+    else return chars32;
+  }
+
+  void widen(size_t newWidth) {
+    if (newWidth == 2) {
+      chars16.assign(chars8.begin(), chars8.end());
+    } else if (width == 1) {
+      chars32.assign(chars8.begin(), chars8.end());
+    } else {
+      chars32.assign(chars16.begin(), chars16.end());
+    }
+    std::vector<uint8_t>().swap(chars8);
+    if (newWidth == 4) std::vector<uint16_t>().swap(chars16);
+    width = newWidth;
+  }
+
+  Rcpp::CharacterVector strings;
+  bool decoded;
+  size_t width = 1;
+  std::vector<size_t> offsets;
+  std::vector<uint8_t> chars8;
+  std::vector<uint16_t> chars16;
+  std::vector<uint32_t> chars32;
+};
+
+// The pool of a string_pool() object, or a pool of a character vector built for a single call
+class StringPoolArg {
+public:
+  explicit StringPoolArg(SEXP x) {
+    if (Rf_inherits(x, "rapidfuzz_string_pool")) {
+      Rcpp::XPtr<StringPool> ptr(x);
+      if (!ptr.get()) {
+        Rcpp::stop("The string pool is no longer valid. Create a new one with string_pool().");
+      }
+      pool = ptr.get();
+    } else {
+      owned.reset(new StringPool(Rcpp::CharacterVector(x)));
+      pool = owned.get();
+    }
+  }
+
+  const StringPool& operator*() const {
+    return *pool;
+  }
+
+  const StringPool* operator->() const {
+    return pool;
+  }
+
+private:
+  std::unique_ptr<StringPool> owned;
+  const StringPool* pool;
+};
+
+// The wider of two character types, which holds the characters of both
+template <typename CharT1, typename CharT2>
+using CommonChar = std::conditional_t<(sizeof(CharT1) > sizeof(CharT2)), CharT1, CharT2>;
+
+// Calls func with values of the character types of two pools whose strings are compared with each other
+template <typename Func>
+auto visitPools(const StringPool& pool1, const StringPool& pool2, Func&& func) {
+  if (pool1.isDecoded() != pool2.isDecoded()) {
+    Rcpp::stop("String pools of decoded characters and of bytes can not be compared.");
+  }
+  return pool1.visit([&](auto tag1) {
+    return pool2.visit([&](auto tag2) { return func(tag1, tag2); });
+  });
+}
+
+// Calls func with a value of the character type of the pool and the characters of query in a type at
+// least as wide, so they can be compared with the strings of the pool. Byte pools read the query as bytes.
+template <typename Func>
+auto visitPoolQuery(const StringPool& pool, const std::string& query, Func&& func) {
+  Utf8Info info = pool.isDecoded() ? utf8Info(query) : Utf8Info();
+  return pool.visit([&](auto tag) {
+    using CharT = decltype(tag);
+    return dispatchCharWidth(std::max(sizeof(CharT), info.width), [&](auto queryTag) {
+      using QueryT = CommonChar<decltype(queryTag), CharT>;
+      Utf8Chars<QueryT> queryChars(query, info);
+      return func(tag, queryChars.chars());
+    });
+  });
+}
+
+#endif
@@ -1,6 +1,7 @@
 #include <Rcpp.h>
 #include <rapidfuzz/details/Range.hpp>
 #include <rapidfuzz/distance/Postfix_impl.hpp>
+#include "rapidfuzz_utf8.h"
 
 #ifndef SIZE_MAX
 #define SIZE_MAX static_cast<size_t>(-1)
@@ -24,7 +25,9 @@ using namespace Rcpp;
 size_t postfix_distance(std::string s1, std::string s2, Rcpp::Nullable<double> score_cutoff = R_NilValue) {
   size_t cutoff_value = score_cutoff.isNull() ? std::numeric_limits<size_t>::max() : Rcpp::as<size_t>(score_cutoff);
   size_t score_hint = std::numeric_limits<size_t>::max();
-  return rapidfuzz::detail::Postfix::distance(s1, s2, cutoff_value, score_hint);
+  return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+    return rapidfuzz::detail::Postfix::distance(chars1, chars2, cutoff_value, score_hint);
+  });
 }
 
 //' @title Postfix Similarity
@@ -41,7 +44,9 @@ size_t postfix_distance(std::string s1, std::string s2, Rcpp::Nullable<double> s
 // [[Rcpp::export]]
 size_t postfix_similarity(std::string s1, std::string s2, size_t score_cutoff = 0) {
   size_t score_hint = 0;
-  return rapidfuzz::detail::Postfix::similarity(s1, s2, score_cutoff, score_hint);
+  return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+    return rapidfuzz::detail::Postfix::similarity(chars1, chars2, score_cutoff, score_hint);
+  });
 }
 
 
@@ -59,7 +64,9 @@ size_t postfix_similarity(std::string s1, std::string s2, size_t score_cutoff =
 // [[Rcpp::export]]
 double postfix_normalized_distance(std::string s1, std::string s2, double score_cutoff = 1.0) {
   double score_hint = 1.0;
-  return rapidfuzz::detail::Postfix::normalized_distance(s1, s2, score_cutoff, score_hint);
+  return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+    return rapidfuzz::detail::Postfix::normalized_distance(chars1, chars2, score_cutoff, score_hint);
+  });
 }
 
 //' @title Normalized Postfix Similarity
@@ -76,5 +83,7 @@ double postfix_normalized_distance(std::string s1, std::string s2, double score_
 // [[Rcpp::export]]
 double postfix_normalized_similarity(std::string s1, std::string s2, double score_cutoff = 0.0) {
   double score_hint = 0.0;
-  return rapidfuzz::detail::Postfix::normalized_similarity(s1, s2, score_cutoff, score_hint);
+  return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+    return rapidfuzz::detail::Postfix::normalized_similarity(chars1, chars2, score_cutoff, score_hint);
+  });
 }
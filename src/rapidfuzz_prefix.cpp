@@ -2,6 +2,7 @@
 #include <string>
 #include <rapidfuzz/details/common.hpp>
 #include <rapidfuzz/distance/Prefix.hpp>
+#include "rapidfuzz_utf8.h"
 
 #ifndef SIZE_MAX
 #define SIZE_MAX static_cast<size_t>(-1)
@@ -24,7 +25,9 @@
 // [[Rcpp::export]]
  size_t prefix_distance(std::string s1, std::string s2, Rcpp::Nullable<double> score_cutoff = R_NilValue) {
    size_t cutoff_value = score_cutoff.isNull() ? std::numeric_limits<size_t>::max() : Rcpp::as<size_t>(score_cutoff);
-   return rapidfuzz::prefix_distance(s1, s2, cutoff_value);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::prefix_distance(chars1, chars2, cutoff_value);
+   });
  }
 
 //' Calculate the prefix similarity between two strings
@@ -41,7 +44,9 @@
 //' @export
 // [[Rcpp::export]]
  size_t prefix_similarity(std::string s1, std::string s2, size_t score_cutoff = 0) {
-   return rapidfuzz::prefix_similarity(s1, s2, score_cutoff);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::prefix_similarity(chars1, chars2, score_cutoff);
+   });
  }
 
 //' Calculate the normalized prefix distance between two strings
@@ -59,7 +64,9 @@
 //' @export
 // [[Rcpp::export]]
  double prefix_normalized_distance(std::string s1, std::string s2, double score_cutoff = 1.0) {
-   return rapidfuzz::prefix_normalized_distance(s1, s2, score_cutoff);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::prefix_normalized_distance(chars1, chars2, score_cutoff);
+   });
  }
 
 //' Calculate the normalized prefix similarity between two strings
@@ -77,5 +84,7 @@
 //' @export
 // [[Rcpp::export]]
  double prefix_normalized_similarity(std::string s1, std::string s2, double score_cutoff = 0.0) {
-   return rapidfuzz::prefix_normalized_similarity(s1, s2, score_cutoff);
+   return visitUtf8(s1, s2, [&](const auto& chars1, const auto& chars2) {
+     return rapidfuzz::prefix_normalized_similarity(chars1, chars2, score_cutoff);
+   });
  }
@@ -0,0 +1,29 @@
+#include <Rcpp.h>
+#include <rapidfuzz/details/Scratch.hpp>
+
+using namespace Rcpp;
+
+//' @name scratch_stats
+//' @title Scratch Buffer Statistics
+//' @description Reports how the temporary buffers of the scorers were served. \code{fuzz_partial_ratio},
+//' the token set ratios and the Levenshtein distance of strings longer than 64 characters borrow their
+//' temporary vectors from a list kept by each thread, so repeated calls, e.g. by the extract and batch
+//' functions, only allocate when a call needs more memory than the calls before it on the same thread.
+//' @param reset If TRUE, the counters are set to zero after they were read.
+//' @return A list with the number of borrowed buffers (\code{requests}), the number of requests that had
+//' to allocate (\code{allocations}) and the number of bytes these allocations added (\code{bytes}), summed
+//' over all threads.
+//' @examples
+//' scratch_stats(reset = TRUE)
+//' extract_matches("new york", c("new york city", "newark", "york"), scorer = "PartialRatio")
+//' scratch_stats()
+//' @export
+// [[Rcpp::export]]
+ Rcpp::List scratch_stats(bool reset = false) {
+   rapidfuzz::ScratchStats stats = rapidfuzz::scratch_stats();
+   if (reset) rapidfuzz::reset_scratch_stats();
+
+   return Rcpp::List::create(Rcpp::Named("requests") = static_cast<double>(stats.requests),
+                             Rcpp::Named("allocations") = static_cast<double>(stats.allocations),
+                             Rcpp::Named("bytes") = static_cast<double>(stats.bytes));
+ }
@@ -0,0 +1,173 @@
+#ifndef RAPIDFUZZ_UTF8_H
+#define RAPIDFUZZ_UTF8_H
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <rapidfuzz/details/Range.hpp>
+#include <rapidfuzz/details/simd.hpp>
+
+// R strings are passed as UTF-8 bytes. They are decoded into code points, so the metrics count
+// characters instead of bytes, and stored in the narrowest type holding all of them: uint8_t when
+// every code point is below 256, else uint16_t or uint32_t. Bytes that are not valid UTF-8 are
+// taken as Latin-1 characters.
+
+// Returns true when no byte has the high bit set, testing 16 bytes per step with SSE2 and 8 bytes
+// per step otherwise
+inline bool isAscii(const char* data, size_t len) {
+  size_t i = 0;
+#if defined(RAPIDFUZZ_SSE2) || defined(RAPIDFUZZ_AVX2)
+  for (; i + 16 <= len; i += 16) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    if (_mm_movemask_epi8(chunk)) return false;
+  }
+#else
+  for (; i + 8 <= len; i += 8) {
+    uint64_t chunk = 0;
+    for (size_t k = 0; k < 8; ++k) {
+      chunk |= static_cast<uint64_t>(static_cast<uint8_t>(data[i + k])) << (8 * k);
+    }
+    if (chunk & UINT64_C(0x8080808080808080)) return false;
+  }
+#endif
+  for (; i < len; ++i) {
+    if (static_cast<uint8_t>(data[i]) & 0x80) return false;
+  }
+  return true;
+}
+
+// Decodes the UTF-8 sequence starting at data[i] and advances i past it. Returns false for an
+// invalid, overlong or truncated sequence, leaving i unchanged.
+inline bool nextCodePoint(const char* data, size_t len, size_t& i, uint32_t& cp) {
+  uint8_t lead = static_cast<uint8_t>(data[i]);
+  size_t count;
+  uint32_t min_cp;
+
+  if (lead < 0x80) {
+    cp = lead;
+    ++i;
+    return true;
+  } else if ((lead & 0xE0) == 0xC0) {
+    count = 1; cp = lead & 0x1F; min_cp = 0x80;
+  } else if ((lead & 0xF0) == 0xE0) {
+    count = 2; cp = lead & 0x0F; min_cp = 0x800;
+  } else if ((lead & 0xF8) == 0xF0) {
+    count = 3; cp = lead & 0x07; min_cp = 0x10000;
+  } else {
+    return false;
+  }
+
+  if (i + count >= len) return false;
+  for (size_t k = 1; k <= count; ++k) {
+    uint8_t byte = static_cast<uint8_t>(data[i + k]);
+    if ((byte & 0xC0) != 0x80) return false;
+    cp = (cp << 6) | (byte & 0x3F);
+  }
+  if (cp < min_cp || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) return false;
+
+  i += count + 1;
+  return true;
+}
+
+// Encoding properties of a string: whether it is plain ASCII, whether it is valid UTF-8 (else it is
+// read as Latin-1) and the number of bytes of the narrowest type holding all its characters
+struct Utf8Info {
+  // every byte is one character, which is also how strings compared as bytes are described
+  bool ascii = true;
+  bool valid = true;
+  size_t width = 1;
+};
+
+inline Utf8Info utf8Info(const char* data, size_t len) {
+  Utf8Info info;
+  if (isAscii(data, len)) return info;
+
+  info.ascii = false;
+  uint32_t max_cp = 0;
+  for (size_t i = 0; i < len;) {
+    uint32_t cp;
+    if (!nextCodePoint(data, len, i, cp)) {
+      info.valid = false;
+      return info;
+    }
+    max_cp = std::max(max_cp, cp);
+  }
+  info.width = max_cp < 0x100 ? 1 : (max_cp < 0x10000 ? 2 : 4);
+  return info;
+}
+
+inline Utf8Info utf8Info(const std::string& s) {
+  return utf8Info(s.data(), s.size());
+}
+
+// Appends the code points of data to a buffer of type CharT, which has to be wide enough for all of them
+template <typename CharT>
+void appendUtf8(const char* data, size_t len, const Utf8Info& info, std::vector<CharT>& out) {
+  if (info.ascii || !info.valid) {
+    out.insert(out.end(), reinterpret_cast<const uint8_t*>(data), reinterpret_cast<const uint8_t*>(data) + len);
+    return;
+  }
+  for (size_t i = 0; i < len;) {
+    uint32_t cp = static_cast<uint8_t>(data[i]);
+    if (!nextCodePoint(data, len, i, cp)) ++i;
+    out.push_back(static_cast<CharT>(cp));
+  }
+}
+
+// Code points of s in a buffer of type CharT, which has to be wide enough for all of them
+template <typename CharT>
+void decodeUtf8(const std::string& s, const Utf8Info& info, std::vector<CharT>& out) {
+  out.clear();
+  out.reserve(s.size());
+  appendUtf8(s.data(), s.size(), info, out);
+}
+
+// Characters of one string in the type selected for a call. ASCII strings are read in place.
+template <typename CharT>
+class Utf8Chars {
+public:
+  Utf8Chars(const std::string& s, const Utf8Info& info) {
+    if (sizeof(CharT) == 1 && info.ascii) {
+      const CharT* data = reinterpret_cast<const CharT*>(s.data());
+      range = rapidfuzz::detail::Range<const CharT*>(data, data + s.size());
+      return;
+    }
+    decodeUtf8(s, info, buffer);
+    range = rapidfuzz::detail::Range<const CharT*>(buffer.data(), buffer.data() + buffer.size());
+  }
+
+  Utf8Chars(const Utf8Chars&) = delete;
+  Utf8Chars& operator=(const Utf8Chars&) = delete;
+
+  const rapidfuzz::detail::Range<const CharT*>& chars() const {
+    return range;
+  }
+
+private:
+  std::vector<CharT> buffer;
+  rapidfuzz::detail::Range<const CharT*> range{nullptr, nullptr};
+};
+
+// Calls func with a value of the character type for a width of 1, 2 or 4 bytes
+template <typename Func>
+auto dispatchCharWidth(size_t width, Func&& func) {
+  if (width == 1) return func(uint8_t());
+  if (width == 2) return func(uint16_t());
+  return func(uint32_t());
+}
+
+// Calls func with the characters of s1 and s2 decoded to their common narrowest type
+template <typename Func>
+auto visitUtf8(const std::string& s1, const std::string& s2, Func&& func) {
+  Utf8Info info1 = utf8Info(s1);
+  Utf8Info info2 = utf8Info(s2);
+  return dispatchCharWidth(std::max(info1.width, info2.width), [&](auto tag) {
+    using CharT = decltype(tag);
+    Utf8Chars<CharT> chars1(s1, info1);
+    Utf8Chars<CharT> chars2(s2, info2);
+    return func(chars1.chars(), chars2.chars());
+  });
+}
+
+#endif
@@ -0,0 +1,118 @@
+#include <Rcpp.h>
+#include <rapidfuzz/distance.hpp>
+#include <rapidfuzz/tokens.hpp>
+#include "rapidfuzz_editops.h"
+#include <string>
+#include <vector>
+
+using namespace Rcpp;
+
+// Splits every pair of s1 and s2 into words, interns them into one dictionary shared by all pairs
+// and calls func with the pair index and the two word id sequences
+template <typename Func>
+static void forEachWordPair(const std::vector<std::string>& s1, const std::vector<std::string>& s2, Func&& func) {
+  if (s1.size() != s2.size()) {
+    Rcpp::stop("s1 and s2 must have the same length.");
+  }
+
+  rapidfuzz::experimental::TokenDictionary<char> dictionary;
+  rapidfuzz::experimental::TokenIdCompactor compact;
+  std::vector<uint32_t> words1;
+  std::vector<uint32_t> words2;
+
+  for (size_t i = 0; i < s1.size(); ++i) {
+    words1.clear();
+    words2.clear();
+    dictionary.tokenize(s1[i].begin(), s1[i].end(), words1);
+    dictionary.tokenize(s2[i].begin(), s2[i].end(), words2);
+    compact(words1, words2);
+    func(i, words1, words2);
+  }
+}
+
+//' @name word_levenshtein_distance
+//' @title Word Level Levenshtein Distance
+//' @description Calculates the Levenshtein distance between the words of two strings, which is the
+//' minimum number of words that have to be inserted, deleted or substituted to transform one string
+//' into the other. Words are separated by whitespace. All words are interned into integer ids, so the
+//' word sequences are compared with the same bit-parallel algorithms as characters.
+//' @param s1 A vector of strings.
+//' @param s2 A vector of strings with the same length as s1.
+//' @return A numeric vector with the word level Levenshtein distance of each pair.
+//' @examples
+//' word_levenshtein_distance("the quick brown fox", "the quick red fox jumps")
+//' @export
+// [[Rcpp::export]]
+ Rcpp::NumericVector word_levenshtein_distance(const std::vector<std::string>& s1,
+                                               const std::vector<std::string>& s2) {
+   Rcpp::NumericVector result(s1.size());
+   forEachWordPair(s1, s2, [&](size_t i, const std::vector<uint32_t>& words1,
+                               const std::vector<uint32_t>& words2) {
+     result[i] = rapidfuzz::levenshtein_distance(words1, words2);
+   });
+   return result;
+ }
+
+//' @name word_lcs_seq_distance
+//' @title Word Level LCSseq Distance
+//' @description Calculates the LCSseq distance between the words of two strings, which is the number
+//' of words that are not part of the longest common subsequence of words. Words are separated by
+//' whitespace.
+//' @param s1 A vector of strings.
+//' @param s2 A vector of strings with the same length as s1.
+//' @return A numeric vector with the word level LCSseq distance of each pair.
+//' @examples
+//' word_lcs_seq_distance("the quick brown fox", "the quick red fox jumps")
+//' @export
+// [[Rcpp::export]]
+ Rcpp::NumericVector word_lcs_seq_distance(const std::vector<std::string>& s1,
+                                           const std::vector<std::string>& s2) {
+   Rcpp::NumericVector result(s1.size());
+   forEachWordPair(s1, s2, [&](size_t i, const std::vector<uint32_t>& words1,
+                               const std::vector<uint32_t>& words2) {
+     result[i] = rapidfuzz::lcs_seq_distance(words1, words2);
+   });
+   return result;
+ }
+
+//' @name word_editops
+//' @title Word Level Edit Operations
+//' @description Calculates the Levenshtein edit operations required to transform the words of one
+//' string into the words of another string. Words are separated by whitespace.
+//' @param s1 A vector of strings.
+//' @param s2 A vector of strings with the same length as s1.
+//' @param types_as_factor If TRUE, the type column is a factor with the levels "delete", "insert" and
+//' "replace" instead of a character vector.
+//' @return A data.frame with one row per edit operation. \code{pair} is the 1-based index of the pair,
+//' \code{type} the operation ("insert", "delete" or "replace") and \code{src_pos} and \code{dest_pos}
+//' the 0-based word positions in s1 and s2.
+//' @examples
+//' word_editops("the quick brown fox", "the quick red fox jumps")
+//' @export
+// [[Rcpp::export]]
+ DataFrame word_editops(const std::vector<std::string>& s1, const std::vector<std::string>& s2,
+                        bool types_as_factor = false) {
+   std::vector<int> pair;
+   std::vector<int> op_type;
+   std::vector<int> src_pos;
+   std::vector<int> dest_pos;
+
+   forEachWordPair(s1, s2, [&](size_t i, const std::vector<uint32_t>& words1,
+                               const std::vector<uint32_t>& words2) {
+     auto ops = rapidfuzz::levenshtein_editops(words1, words2);
+
+     for (const auto& op : ops) {
+       pair.push_back(static_cast<int>(i) + 1);
+       src_pos.push_back(op.src_pos);
+       dest_pos.push_back(op.dest_pos);
+       op_type.push_back(editTypeCode(op.type));
+     }
+   });
+
+   return DataFrame::create(
+     Named("pair") = pair,
+     Named("type") = editTypeColumn(op_type, types_as_factor),
+     Named("src_pos") = src_pos,
+     Named("dest_pos") = dest_pos
+   );
+ }